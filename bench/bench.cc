@@ -0,0 +1,694 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+// Benchmarks of the hot paths of embers on a headless context. Results are
+// printed as JSON with one metric per line, so runs on two commits diff
+// cleanly:
+//
+//   embers_bench [--quick] [--output results.json]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <embers/asset_loader.h>
+#include <embers/command_buffer.h>
+#include <embers/compiler.h>
+#include <embers/frame_scheduler.h>
+#include <embers/gl_handle.h>
+#include <embers/gl_state.h>
+#include <embers/headless.h>
+#include <embers/instancing.h>
+#include <embers/program_cache.h>
+#include <embers/job_system.h>
+#include <embers/render_queue.h>
+#include <embers/shader.h>
+#include <embers/shader_library.h>
+#include <embers/shader_watcher.h>
+#include <embers/stream_buffer.h>
+#include <embers/uniform_buffer.h>
+#include <embers/vertex.h>
+
+namespace {
+using namespace embers;
+using namespace embers::shader::literals;
+using Clock = std::chrono::steady_clock;
+
+constexpr int kWidth = 1280;
+constexpr int kHeight = 720;
+
+const char *const kVertexShader =
+  "#version 330 core\n"
+  "layout (location = 0) in vec2 aPos;\n"
+  "layout (location = 1) in vec3 aColor;\n"
+  "out vec3 vertexColor;\n"
+  "void main() {\n"
+  "  gl_Position = vec4(aPos, 0, 1);\n"
+  "  vertexColor = aColor;\n"
+  "}\n";
+
+// Places a unit triangle per instance, see render::Instance2D
+const char *const kInstancedVertexShader =
+  "#version 330 core\n"
+  "layout (location = 0) in vec2 aPos;\n"
+  "layout (location = 2) in vec3 row0;\n"
+  "layout (location = 3) in vec3 row1;\n"
+  "layout (location = 4) in vec4 color;\n"
+  "out vec3 vertexColor;\n"
+  "void main() {\n"
+  "  vec3 position = vec3(aPos, 1);\n"
+  "  gl_Position = vec4(dot(row0, position), dot(row1, position), 0, 1);\n"
+  "  vertexColor = color.rgb;\n"
+  "}\n";
+
+const char *const kFragmentShader =
+  "out vec4 FragColor;\n"
+  "in vec3 vertexColor;\n"
+  "uniform float scale;\n"
+  "uniform int mode;\n"
+  "layout(std140) uniform Frame {\n"
+  "  float time;\n"
+  "};\n"
+  "void main() {\n"
+  "  vec3 color = vertexColor * scale * VARIANT;\n"
+  "  FragColor = vec4(mode == 0 ? color : color.bgr, time);\n"
+  "}\n";
+
+struct Vertex {
+  vertex::Vec<GLfloat, 2> position;
+  vertex::Vec<GLubyte, 3, true> color;
+};
+
+struct FrameUniforms {
+  GLfloat time;
+};
+
+struct Result {
+  std::string name;
+  double value;
+  const char *unit;
+};
+
+double Seconds(const Clock::duration duration) {
+  return std::chrono::duration<double>(duration).count();
+}
+
+double Nanoseconds(const Clock::duration duration) {
+  return std::chrono::duration<double, std::nano>(duration).count();
+}
+
+// Fragment shaders differ in a constant, so no driver cache can serve them
+shader::Source FragmentSource(const int variant) {
+  const std::string text = "#version 330 core\n#define VARIANT " + std::to_string(1.0 + variant * 1e-3) + "\n"
+                           + kFragmentShader;
+  return {text.c_str(), shader::Type::kFragment};
+}
+
+shader::Program BuildProgram(const int variant) {
+  const shader::Source vertex(kVertexShader, shader::Type::kVertex);
+  const shader::Source fragment = FragmentSource(variant);
+  return shader::Program::Builder().AttachSource(vertex).AttachSource(fragment).Link();
+}
+
+void BenchCompile(std::vector<Result> &results, Headless &context, const int programs, int &variant) {
+  auto start = Clock::now();
+  for (int i = 0; i < programs; ++i) {
+    BuildProgram(variant++);
+  }
+  results.push_back({"compile_link.builder", programs / Seconds(Clock::now() - start), "programs/s"});
+
+  std::vector<shader::Source> fragments;
+  fragments.reserve(programs);
+  for (int i = 0; i < programs; ++i) {
+    fragments.push_back(FragmentSource(variant++));
+  }
+  const shader::Source vertex(kVertexShader, shader::Type::kVertex);
+  start = Clock::now();
+  {
+    shader::Compiler compiler(context.CompileContext());
+    std::vector<shader::ProgramFuture> futures;
+    futures.reserve(programs);
+    for (const shader::Source &fragment : fragments) {
+      futures.push_back(compiler.Build({vertex, fragment}));
+    }
+    for (shader::ProgramFuture &future : futures) {
+      future.Get();
+    }
+  }
+  results.push_back({"compile_link.compiler", programs / Seconds(Clock::now() - start), "programs/s"});
+}
+
+void WriteFile(const std::filesystem::path &path, const std::string &text) {
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream(path, std::ios::binary) << text;
+}
+
+// Variants of one fragment shader put together by a shader::Library from
+// shared, included text. Also checks a load that failed on a missing include
+// succeeds once the include is there
+void BenchLibrary(std::vector<Result> &results, const int variants) {
+  const std::filesystem::path directory = std::filesystem::temp_directory_path() / "embers_bench_library";
+  // Left behind if an earlier run failed
+  std::filesystem::remove_all(directory);
+  WriteFile(directory / "frame.frag", std::string("#version 330 core\n#include \"inc/common.glsl\"\n") + kFragmentShader);
+  WriteFile(directory / "inc/common.glsl", "#include \"inc/missing.glsl\"\n");
+
+  shader::Library library(directory);
+  try {
+    library.Load("frame.frag", shader::Type::kFragment);
+    throw std::runtime_error("shader::Library: loaded a shader with a missing include");
+  } catch (const shader::ShaderException &) {}
+  WriteFile(directory / "inc/missing.glsl", "// found\n");
+  library.Load("frame.frag", shader::Type::kFragment, {"VARIANT=1.0"});
+
+  std::vector<std::string> defines;
+  for (int i = 0; i < variants; ++i) {
+    defines.push_back("VARIANT=" + std::to_string(1.0 + i * 1e-3));
+  }
+  const auto start = Clock::now();
+  for (const std::string &define : defines) {
+    library.Load("frame.frag", shader::Type::kFragment, {define});
+  }
+  results.push_back({"shader_library.load", Nanoseconds(Clock::now() - start) / variants, "ns/variant"});
+  std::filesystem::remove_all(directory);
+}
+
+// Edits of one file out of `programs` watched ones, each timed from the
+// first Poll after the write to the reloaded program. Also checks an include
+// that was broken reloads again once it is fixed
+void BenchReload(std::vector<Result> &results, const int programs, const int edits) {
+  const std::filesystem::path directory = std::filesystem::temp_directory_path() / "embers_bench_reload";
+  std::filesystem::remove_all(directory);
+  const auto include_name = [](const int program) { return "inc/p" + std::to_string(program) + ".glsl"; };
+  const auto write_include = [&](const int program, const int version) {
+    WriteFile(directory / include_name(program), "#define VARIANT " + std::to_string(1.0 + version * 1e-3) + "\n");
+  };
+  WriteFile(directory / "reload.vert", kVertexShader);
+  for (int i = 0; i < programs; ++i) {
+    WriteFile(
+      directory / ("p" + std::to_string(i) + ".frag"),
+      "#version 330 core\n#include \"" + include_name(i) + "\"\n" + kFragmentShader
+    );
+    write_include(i, i);
+  }
+
+  shader::Library library(directory);
+  std::ostringstream log;
+  shader::Watcher watcher(library, log);
+  std::vector<shader::Program> built;
+  built.reserve(programs);
+  for (int i = 0; i < programs; ++i) {
+    const std::string fragment = "p" + std::to_string(i) + ".frag";
+    const shader::Source vertex_source = library.Load("reload.vert", shader::Type::kVertex);
+    const shader::Source fragment_source = library.Load(fragment, shader::Type::kFragment);
+    built.push_back(shader::Program::Builder().AttachSource(vertex_source).AttachSource(fragment_source).Link());
+    watcher.Watch(built.back(), {{"reload.vert", shader::Type::kVertex, {}}, {fragment, shader::Type::kFragment, {}}});
+  }
+
+  // Events are queued when the file is closed, so they are there right away
+  const auto reload = [&watcher] {
+    const auto deadline = Clock::now() + std::chrono::seconds(1);
+    std::size_t reloaded = 0;
+    while (!(reloaded = watcher.Poll()) && Clock::now() < deadline) {}
+    return reloaded;
+  };
+  Clock::duration total{};
+  for (int edit = 0; edit < edits; ++edit) {
+    write_include(0, programs + edit);
+    const auto start = Clock::now();
+    if (reload() != 1) {
+      throw std::runtime_error("shader::Watcher: an edit did not reload exactly one program");
+    }
+    total += Clock::now() - start;
+  }
+  results.push_back({"shader_reload.latency", Seconds(total) / edits * 1000, "ms"});
+
+  WriteFile(directory / include_name(0), "#include \"inc/missing.glsl\"\n");
+  const GLuint kept = static_cast<GLuint>(built.front());
+  if (watcher.Poll() != 0 || static_cast<GLuint>(built.front()) != kept) {
+    throw std::runtime_error("shader::Watcher: a broken include replaced the program");
+  }
+  write_include(0, 0);
+  if (reload() != 1) {
+    throw std::runtime_error("shader::Watcher: a fixed include did not reload: " + log.str());
+  }
+  built.clear();
+  gl::Collect();
+  std::filesystem::remove_all(directory);
+}
+
+// The same programs built against an empty cache directory, then restored
+// from it by a new cache, as a first and a later process start would
+void BenchProgramCache(std::vector<Result> &results, const int programs) {
+  const std::filesystem::path directory = std::filesystem::temp_directory_path() / "embers_bench_program_cache";
+  std::filesystem::remove_all(directory);
+  // Unique to this run, so a cache in the driver cannot make the cold start
+  // warm
+  const std::string salt = "// " + std::to_string(Clock::now().time_since_epoch().count()) + "\n";
+  const shader::Source vertex((kVertexShader + salt).c_str(), shader::Type::kVertex);
+  std::vector<shader::Source> fragments;
+  fragments.reserve(programs);
+  for (int i = 0; i < programs; ++i) {
+    const std::string text = "#version 330 core\n#define VARIANT " + std::to_string(1.0 + i * 1e-3) + "\n"
+                             + kFragmentShader + salt;
+    fragments.emplace_back(text.c_str(), shader::Type::kFragment);
+  }
+
+  const auto build = [&] {
+    shader::ProgramCache cache(directory);
+    const auto start = Clock::now();
+    for (const shader::Source &fragment : fragments) {
+      shader::Program::Builder().UseCache(cache).AttachSource(vertex).AttachSource(fragment).Link();
+    }
+    glFinish();
+    return Seconds(Clock::now() - start) * 1000 / programs;
+  };
+  results.push_back({"program_cache.cold", build(), "ms/program"});
+  results.push_back({"program_cache.warm", build(), "ms/program"});
+  gl::Collect();
+  std::filesystem::remove_all(directory);
+}
+
+void BenchUniforms(std::vector<Result> &results, shader::Program &program, const int iterations) {
+  program.use();
+  const auto scale = program.uniform<GLfloat>("scale"_uniform);
+  // Warms up the driver, so the first measurement is not penalised
+  for (int i = 0; i < iterations / 10; ++i) {
+    program.setUniform(scale, static_cast<GLfloat>(i));
+  }
+  glFinish();
+  auto start = Clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    program.setUniform(scale, static_cast<GLfloat>(i));
+  }
+  glFinish();
+  results.push_back({"set_uniform.handle", Nanoseconds(Clock::now() - start) / iterations, "ns/call"});
+
+  start = Clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    program.setUniform("scale", static_cast<GLfloat>(i));
+  }
+  glFinish();
+  results.push_back({"set_uniform.name", Nanoseconds(Clock::now() - start) / iterations, "ns/call"});
+
+  gl::UniformBuffer<FrameUniforms> frame(0);
+  frame.Attach(program, "Frame"_uniform);
+  start = Clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    frame.data().time = static_cast<GLfloat>(i);
+    frame.Upload();
+  }
+  glFinish();
+  results.push_back({"uniform_buffer.upload", Nanoseconds(Clock::now() - start) / iterations, "ns/call"});
+
+  // A ring whose size is not a multiple of the alignment, so the regions
+  // after each wrap would be misaligned if the offsets were
+  GLint alignment = 0;
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  gl::StreamBuffer stream(GL_UNIFORM_BUFFER, 16 * std::max(alignment, 16) + 8);
+  while (glGetError() != GL_NO_ERROR) {}
+  start = Clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    frame.data().time = static_cast<GLfloat>(i);
+    frame.Upload(stream);
+    if (i % 4 == 3) {
+      stream.EndFrame();
+    }
+  }
+  glFinish();
+  results.push_back({"uniform_buffer.stream", Nanoseconds(Clock::now() - start) / iterations, "ns/call"});
+  GLint64 offset = 0;
+  glGetInteger64i_v(GL_UNIFORM_BUFFER_START, frame.binding(), &offset);
+  if (stream.statistics().wraps == 0 || offset % alignment != 0 || glGetError() != GL_NO_ERROR) {
+    throw std::runtime_error("gl::StreamBuffer: a streamed uniform buffer was bound misaligned after a wrap");
+  }
+}
+
+// Many small triangles spread over a few vertex arrays and programs, like a
+// scene of small objects
+class Scene {
+  public:
+    static constexpr int kVertexArrays = 4;
+
+    Scene(std::vector<shader::Program> &programs, const int triangles)
+      : programs_(programs)
+    , triangles_(triangles)
+    , buffer_(gl::Buffer::Create())
+    , frame_(0) {
+      std::vector<Vertex> vertices;
+      vertices.reserve(triangles * 3);
+      const int side = static_cast<int>(std::ceil(std::sqrt(triangles)));
+      for (int i = 0; i < triangles; ++i) {
+        const GLfloat x = -1 + 2.f * (i % side) / side;
+        const GLfloat y = -1 + 2.f * (i / side) / side;
+        const GLfloat size = 2.f / side;
+        const auto shade = static_cast<GLubyte>(i * 37);
+        vertices.push_back({{x, y}, {shade, 0, 255}});
+        vertices.push_back({{x + size, y}, {0, shade, 255}});
+        vertices.push_back({{x, y + size}, {255, 0, shade}});
+      }
+
+      gl::State &state = gl::State::Current();
+      state.BindBuffer(GL_ARRAY_BUFFER, buffer_.get());
+      glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+      for (gl::VertexArray &vertex_array : vertex_arrays_) {
+        vertex_array = gl::VertexArray::Create();
+        state.BindVertexArray(vertex_array.get());
+        vertex::SetAttributes<Vertex>(0, buffer_.get());
+      }
+      for (shader::Program &program : programs_) {
+        frame_.Attach(program, "Frame"_uniform);
+      }
+    }
+    Scene(const Scene &) = delete;
+
+    // Draws every triangle with its own call, in object order
+    void DrawImmediate() {
+      gl::State &state = gl::State::Current();
+      for (int i = 0; i < triangles_; ++i) {
+        programs_[i % programs_.size()].use();
+        state.BindVertexArray(vertex_arrays_[i % kVertexArrays].get());
+        glDrawArrays(GL_TRIANGLES, i * 3, 3);
+      }
+    }
+
+    // Records the triangles in [begin, end) the way DrawImmediate draws them
+    void Record(render::CommandBuffer &buffer, const std::size_t begin, const std::size_t end) {
+      for (std::size_t i = begin; i < end; ++i) {
+        buffer.UseProgram(programs_[i % programs_.size()]);
+        buffer.BindVertexArray(vertex_arrays_[i % kVertexArrays].get());
+        buffer.DrawArrays(GL_TRIANGLES, static_cast<GLint>(i * 3), 3);
+      }
+    }
+
+    void DrawQueued(render::Queue &queue) {
+      for (int i = 0; i < triangles_; ++i) {
+        queue.DrawArrays(programs_[i % programs_.size()], vertex_arrays_[i % kVertexArrays].get(), GL_TRIANGLES, i * 3, 3);
+      }
+      queue.Submit();
+    }
+
+    void BeginFrame() {
+      glClear(GL_COLOR_BUFFER_BIT);
+      frame_.data().time = static_cast<GLfloat>(frame_count_++);
+      frame_.Upload();
+    }
+
+  private:
+    std::vector<shader::Program> &programs_;
+    int triangles_;
+    gl::VertexArray vertex_arrays_[kVertexArrays];
+    gl::Buffer buffer_;
+    gl::UniformBuffer<FrameUniforms> frame_;
+    int frame_count_ = 0;
+};
+
+void BenchDraws(std::vector<Result> &results, Scene &scene, const int triangles, const int frames) {
+  // CPU time to submit, with the GPU drained before each frame
+  Clock::duration immediate{};
+  for (int frame = 0; frame < frames; ++frame) {
+    scene.BeginFrame();
+    glFinish();
+    const auto start = Clock::now();
+    scene.DrawImmediate();
+    immediate += Clock::now() - start;
+  }
+  results.push_back({"draw_submission.immediate", triangles * frames / Seconds(immediate), "draws/s"});
+
+  render::Queue queue;
+  Clock::duration queued{};
+  for (int frame = 0; frame < frames; ++frame) {
+    scene.BeginFrame();
+    glFinish();
+    const auto start = Clock::now();
+    scene.DrawQueued(queue);
+    queued += Clock::now() - start;
+  }
+  glFinish();
+  results.push_back({"draw_submission.queue", triangles * frames / Seconds(queued), "draws/s"});
+
+  // Recorded in parallel, a command buffer per chunk, and replayed in order
+  JobSystem jobs;
+  const std::size_t grain = 1024;
+  std::vector<render::CommandBuffer> buffers((triangles + grain - 1) / grain);
+  Clock::duration recorded{};
+  for (int frame = 0; frame < frames; ++frame) {
+    scene.BeginFrame();
+    glFinish();
+    const auto start = Clock::now();
+    jobs.ParallelFor(triangles, grain, [&](const std::size_t begin, const std::size_t end) {
+      render::CommandBuffer &buffer = buffers[begin / grain];
+      buffer.Clear();
+      scene.Record(buffer, begin, end);
+    });
+    for (const render::CommandBuffer &buffer : buffers) {
+      buffer.Replay();
+    }
+    recorded += Clock::now() - start;
+  }
+  glFinish();
+  results.push_back({"draw_submission.command_buffers", triangles * frames / Seconds(recorded), "draws/s"});
+  results.push_back({
+    "draw_submission.queue_calls",
+    static_cast<double>(queue.statistics().draw_calls) / frames,
+    "calls/frame"
+  });
+}
+
+// The triangles of Scene as instances of one, placed anew every frame
+void BenchInstancing(std::vector<Result> &results, const int triangles, const int frames, int &variant) {
+  const shader::Source vertex(kInstancedVertexShader, shader::Type::kVertex);
+  const shader::Source fragment = FragmentSource(variant++);
+  shader::Program program = shader::Program::Builder().AttachSource(vertex).AttachSource(fragment).Link();
+  program.use().setUniform("scale", 1.f);
+  gl::UniformBuffer<FrameUniforms> frame(0);
+  frame.Attach(program, "Frame"_uniform);
+  frame.Upload();
+
+  constexpr Vertex triangle[] = {
+    {{0, 0}, {255, 255, 255}},
+    {{1, 0}, {255, 255, 255}},
+    {{0, 1}, {255, 255, 255}}
+  };
+  gl::State &state = gl::State::Current();
+  const gl::VertexArray vertex_array = gl::VertexArray::Create();
+  const gl::Buffer buffer = gl::Buffer::Create();
+  state.BindVertexArray(vertex_array.get());
+  state.BindBuffer(GL_ARRAY_BUFFER, buffer.get());
+  glBufferData(GL_ARRAY_BUFFER, sizeof(triangle), triangle, GL_STATIC_DRAW);
+  vertex::SetAttributes<Vertex>(0, buffer.get());
+
+  gl::StreamBuffer instances(GL_ARRAY_BUFFER, 4 * triangles * sizeof(render::Instance2D));
+  render::InstanceStream<render::Instance2D> stream(instances, vertex_array.get(), 2);
+  const int side = static_cast<int>(std::ceil(std::sqrt(triangles)));
+  const GLfloat size = 2.f / side;
+
+  Clock::duration instanced{};
+  for (int frame_index = 0; frame_index < frames; ++frame_index) {
+    glClear(GL_COLOR_BUFFER_BIT);
+    glFinish();
+    const auto start = Clock::now();
+    stream.Begin(triangles);
+    for (int i = 0; i < triangles; ++i) {
+      const GLfloat x = -1 + 2.f * (i % side) / side;
+      const GLfloat y = -1 + 2.f * (i / side) / side;
+      stream.Push(render::Instance2D::At(x, y, 0, size, {static_cast<GLubyte>(i * 37), 0, 255, 255}));
+    }
+    const GLsizei count = stream.End();
+    program.use();
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 3, count);
+    instances.EndFrame();
+    instanced += Clock::now() - start;
+  }
+  glFinish();
+  results.push_back({"draw_submission.instanced", triangles * frames / Seconds(instanced), "draws/s"});
+}
+
+// Buffers created and given back, as a scene load and teardown do
+void BenchObjects(std::vector<Result> &results, const int objects) {
+  gl::State &state = gl::State::Current();
+  std::vector<GLuint> names(objects);
+  auto start = Clock::now();
+  for (GLuint &name : names) {
+    glGenBuffers(1, &name);
+    state.BindBuffer(GL_ARRAY_BUFFER, name);
+  }
+  for (const GLuint name : names) {
+    state.ForgetBuffer(name);
+    glDeleteBuffers(1, &name);
+  }
+  glFinish();
+  results.push_back({"gl_objects.direct", Nanoseconds(Clock::now() - start) / objects, "ns/object"});
+
+  std::vector<gl::Buffer> buffers(objects);
+  start = Clock::now();
+  for (gl::Buffer &buffer : buffers) {
+    buffer = gl::Buffer::Create();
+    state.BindBuffer(GL_ARRAY_BUFFER, buffer.get());
+  }
+  buffers.clear();
+  gl::Collect();
+  glFinish();
+  results.push_back({"gl_objects.pooled", Nanoseconds(Clock::now() - start) / objects, "ns/object"});
+}
+
+// Textures and a mesh written to a temporary directory, loaded once all at
+// once and once pumped a frame at a time
+void BenchAssets(std::vector<Result> &results, const int textures) {
+  const std::filesystem::path directory = std::filesystem::temp_directory_path() / "embers_bench";
+  std::filesystem::create_directories(directory);
+  constexpr int kSize = 1024;
+  std::vector<std::filesystem::path> paths;
+  for (int i = 0; i < textures; ++i) {
+    std::string image = "P6 " + std::to_string(kSize) + " " + std::to_string(kSize) + " 255\n";
+    for (int pixel = 0; pixel < kSize * kSize * 3; ++pixel) {
+      image += static_cast<char>(pixel * (i + 1));
+    }
+    paths.push_back(directory / ("texture" + std::to_string(i) + ".ppm"));
+    std::ofstream(paths.back(), std::ios::binary) << image;
+  }
+  constexpr int kGrid = 256;
+  std::ofstream obj(directory / "grid.obj");
+  for (int y = 0; y <= kGrid; ++y) {
+    for (int x = 0; x <= kGrid; ++x) {
+      obj << "v " << x << " " << y << " 0\nvt " << x / float(kGrid) << " " << y / float(kGrid) << "\n";
+    }
+  }
+  for (int y = 0; y < kGrid; ++y) {
+    for (int x = 0; x < kGrid; ++x) {
+      const int corner = y * (kGrid + 1) + x + 1;
+      obj << "f " << corner << "/" << corner << " " << corner + 1 << "/" << corner + 1 << " "
+        << corner + kGrid + 2 << "/" << corner + kGrid + 2 << " " << corner + kGrid + 1 << "/" << corner + kGrid + 1 << "\n";
+    }
+  }
+  obj.close();
+
+  JobSystem jobs;
+  const auto load = [&](asset::Loader &loader) {
+    std::vector<asset::Future<asset::Texture>> loaded;
+    for (const std::filesystem::path &path : paths) {
+      loaded.push_back(loader.LoadTexture(path));
+    }
+    return std::pair(std::move(loaded), loader.LoadMesh(directory / "grid.obj"));
+  };
+
+  {
+    asset::Loader loader(jobs);
+    const auto start = Clock::now();
+    auto loaded = load(loader);
+    loader.Finish();
+    glFinish();
+    const double seconds = Seconds(Clock::now() - start);
+    results.push_back({"assets.load", loader.statistics().bytes / seconds / (1 << 20), "MB/s"});
+  }
+  gl::Collect();
+
+  // The longest a frame spends in Pump is what loading adds to it
+  {
+    asset::Loader loader(jobs);
+    auto loaded = load(loader);
+    Clock::duration longest{};
+    while (loader.pending()) {
+      const auto start = Clock::now();
+      loader.Pump(2 << 20);
+      longest = std::max(longest, Clock::now() - start);
+      glFinish();
+      gl::Collect();
+    }
+    results.push_back({"assets.pump_max", Seconds(longest) * 1000, "ms"});
+  }
+  gl::Collect();
+  std::filesystem::remove_all(directory);
+}
+
+void BenchFrames(std::vector<Result> &results, Scene &scene, const int frames) {
+  FrameScheduler scheduler(60, FrameScheduler::Mode::kUncapped, std::chrono::microseconds(0), frames);
+  render::Queue queue;
+  for (int frame = 0; frame <= frames; ++frame) {
+    scheduler.WaitForNextFrame();
+    scene.BeginFrame();
+    scene.DrawQueued(queue);
+    glFinish();
+    gl::Collect();
+  }
+  const FrameScheduler::Statistics statistics = scheduler.statistics();
+  results.push_back({"frame_time.mean", statistics.mean, "ms"});
+  results.push_back({"frame_time.p99", statistics.p99, "ms"});
+  results.push_back({"frame_time.max", statistics.max, "ms"});
+}
+
+void WriteResults(std::ostream &output, const std::vector<Result> &results) {
+  output << "{\n";
+  output << "  \"renderer\": \"" << glGetString(GL_RENDERER) << "\",\n";
+  output << "  \"version\": \"" << glGetString(GL_VERSION) << "\",\n";
+  output << "  \"results\": {\n";
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    output << "    \"" << results[i].name << "\": {\"value\": " << results[i].value
+      << ", \"unit\": \"" << results[i].unit << "\"}" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  output << "  }\n}" << std::endl;
+}
+}
+
+int main(const int argc, char **argv) {
+  bool quick = false;
+  const char *output_path = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--quick") == 0) {
+      quick = true;
+    } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+      output_path = argv[++i];
+    } else {
+      std::cerr << "usage: " << argv[0] << " [--quick] [--output results.json]" << std::endl;
+      return 2;
+    }
+  }
+  const int scale = quick ? 1 : 10;
+
+  try {
+    Headless context(kWidth, kHeight);
+    std::vector<Result> results;
+    int variant = 0;
+
+    BenchCompile(results, context, 4 * scale, variant);
+    BenchProgramCache(results, 4 * scale);
+    gl::Collect();
+
+    std::vector<shader::Program> programs;
+    for (int i = 0; i < 2; ++i) {
+      programs.push_back(BuildProgram(variant++));
+    }
+    BenchLibrary(results, 1000 * scale);
+    BenchReload(results, 20 * scale, 5);
+    BenchUniforms(results, programs.front(), 10'000 * scale);
+
+    const int triangles = 10'000;
+    Scene scene(programs, triangles);
+    BenchDraws(results, scene, triangles, 3 * scale);
+    BenchInstancing(results, triangles, 3 * scale, variant);
+    BenchObjects(results, 1000 * scale);
+    BenchAssets(results, 2 * scale);
+    BenchFrames(results, scene, 10 * scale);
+
+    if (output_path) {
+      std::ofstream output(output_path);
+      WriteResults(output, results);
+    } else {
+      WriteResults(std::cout, results);
+    }
+  } catch (const std::exception &error) {
+    std::cerr << error.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,63 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef ASSET_H
+#define ASSET_H
+
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include <glad/glad.h>
+
+#include <embers/vertex.h>
+
+// Decoders for the image and mesh files the asset loader reads. They only
+// touch memory, so they are safe to run on any thread
+namespace embers::asset {
+class AssetException final : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+// 8 bits per channel, rows bottom first as glTexImage2D takes them
+struct Image {
+  int width = 0;
+  int height = 0;
+  // 1 grey, 3 RGB or 4 RGBA
+  int channels = 0;
+  std::vector<std::uint8_t> pixels;
+};
+
+struct MeshVertex {
+  vertex::Vec<GLfloat, 3> position;
+  vertex::Vec<GLfloat, 3> normal;
+  vertex::Vec<GLfloat, 2> uv;
+};
+
+// Indexed triangles. Attributes a file does not give are zero
+struct Mesh {
+  std::vector<MeshVertex> vertices;
+  std::vector<std::uint32_t> indices;
+};
+
+// Binary PPM and PGM, P6 and P5, with up to 8 bits per channel. Throws
+// AssetException if the data is malformed
+Image DecodePnm(std::string_view data);
+// Uncompressed and run-length encoded true colour and greyscale TGA
+Image DecodeTga(std::string_view data);
+// Vertices, texture coordinates, normals and faces of a Wavefront OBJ.
+// Polygons are split into triangle fans, and vertices sharing all of their
+// attributes are merged
+Mesh DecodeObj(std::string_view text);
+
+// Pick the decoder by extension: .ppm, .pgm, .pnm, .tga and .obj. Throw
+// AssetException for other extensions, and std::system_error if the file
+// cannot be read
+Image LoadImage(const std::filesystem::path &path);
+Mesh LoadMesh(const std::filesystem::path &path);
+}
+
+#endif //ASSET_H
@@ -0,0 +1,161 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+#include <glad/glad.h>
+
+#include <embers/asset.h>
+#include <embers/gl_handle.h>
+#include <embers/job_system.h>
+#include <embers/stream_buffer.h>
+
+namespace embers::asset {
+// An RGBA8, RGB8 or R8 texture with one level and linear filtering
+struct Texture {
+  gl::Texture texture;
+  int width = 0;
+  int height = 0;
+};
+
+// A vertex array reading MeshVertex at locations 0 to 2, position, normal
+// and uv, with 32-bit indices
+struct GpuMesh {
+  gl::VertexArray vertex_array;
+  gl::Buffer vertex_buffer;
+  gl::Buffer index_buffer;
+  GLsizei index_count = 0;
+};
+
+namespace detail {
+template<typename T>
+struct Slot {
+  std::optional<T> value;
+  std::exception_ptr error;
+  bool done = false;
+};
+}
+
+// The result of a load, filled in by Loader::Pump. Only for the GL thread
+template<typename T>
+class Future {
+  public:
+    Future() = default;
+
+    [[nodiscard]] bool Ready() const {
+      return slot_ && slot_->done;
+    }
+    // Rethrows what failed the load. Throws std::logic_error before Ready
+    T &Get() const {
+      if (!Ready()) {
+        throw std::logic_error("asset::Future: not ready");
+      }
+      if (slot_->error) {
+        std::rethrow_exception(slot_->error);
+      }
+      return *slot_->value;
+    }
+
+  private:
+    friend class Loader;
+
+    std::shared_ptr<detail::Slot<T>> slot_;
+
+    explicit Future(std::shared_ptr<detail::Slot<T>> slot) : slot_(std::move(slot)) {}
+};
+
+// Loads textures and meshes without stalling the frame. Files are read and
+// decoded by tasks on a JobSystem, and the GL thread uploads the results a
+// bounded number of bytes per frame:
+//
+//   auto texture = loader.LoadTexture("crate.tga");
+//   ...
+//   loader.Pump(4 << 20);  // once per frame
+//   if (texture.Ready()) {
+//     glBindTexture(GL_TEXTURE_2D, texture.Get().texture.get());
+//   }
+//
+// Uploads go through a staging StreamBuffer: texture rows are unpacked from
+// it as a pixel buffer and mesh data is copied from it on the GPU. The GL
+// thread only copies into mapped memory, and the transfers to the textures
+// and buffers overlap with rendering
+class Loader {
+  public:
+    struct Statistics {
+      std::size_t textures = 0;
+      std::size_t meshes = 0;
+      std::size_t failed = 0;
+      // Copied through the staging buffer
+      std::size_t bytes = 0;
+    };
+
+    // Call on the GL thread, as every other member. `staging_size` bounds
+    // the bytes in flight between Pumps; the widest texture row has to fit
+    // in a quarter of it
+    explicit Loader(JobSystem &jobs, GLsizeiptr staging_size = 8 << 20);
+    Loader(const Loader &) = delete;
+    Loader &operator=(const Loader &) = delete;
+
+    Future<Texture> LoadTexture(const std::filesystem::path &path);
+    Future<GpuMesh> LoadMesh(const std::filesystem::path &path);
+
+    // Uploads about `byte_budget` bytes of decoded assets, oldest first, and
+    // completes the futures of the ones that are done. Always makes some
+    // progress, at least one row of a texture, however small the budget.
+    // Changes the GL_TEXTURE_2D binding of the active texture unit and the
+    // bound vertex array
+    void Pump(GLsizeiptr byte_budget);
+    // Waits for every decode and uploads all of it
+    void Finish();
+
+    // Loads not completed yet
+    [[nodiscard]] std::size_t pending() const;
+    [[nodiscard]] const Statistics &statistics() const {
+      return statistics_;
+    }
+
+  private:
+    struct Job;
+
+    // Where decode tasks hand their jobs to the GL thread. Shared with the
+    // tasks, which may finish after the loader is gone
+    struct Inbox {
+      std::mutex mutex;
+      std::condition_variable decoded;
+      std::vector<std::shared_ptr<Job>> jobs;
+      std::size_t decoding = 0;
+    };
+
+    JobSystem &jobs_;
+    gl::StreamBuffer staging_;
+    // Largest copy through the staging buffer, so a few fit in flight
+    GLsizeiptr max_chunk_;
+    std::shared_ptr<Inbox> inbox_;
+    // Decoded and waiting for, or part way through, their upload
+    std::deque<std::shared_ptr<Job>> uploads_;
+    Statistics statistics_;
+
+    void Decode(std::shared_ptr<Job> job);
+    // Each returns whether the job is done, and takes what it uploaded from
+    // `budget`. `progressed` is whether this Pump uploaded anything yet
+    bool UploadTexture(Job &job, GLsizeiptr &budget, bool &progressed);
+    bool UploadMesh(Job &job, GLsizeiptr &budget, bool &progressed);
+    GLintptr Stage(const void *data, GLsizeiptr size);
+    void Complete(Job &job);
+    void Fail(Job &job, std::exception_ptr error);
+};
+}
+
+#endif //ASSET_LOADER_H
@@ -0,0 +1,86 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef COMMAND_BUFFER_H
+#define COMMAND_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glad/glad.h>
+
+#include <embers/shader.h>
+
+namespace embers::render {
+// Rendering commands recorded without calling GL, so any thread can build
+// them, and replayed later on the GL thread. Each command is an opcode byte
+// followed by its arguments, packed into blocks the buffer owns. Clear keeps
+// the blocks, so recording a frame after the first rarely allocates.
+//
+// One thread at a time may record into a buffer. Programs and GL objects
+// recorded have to outlive the replay. Replaying buffers in an order the
+// caller fixes gives the same GL calls however their recording was spread
+// over threads
+class CommandBuffer {
+  public:
+    static constexpr std::size_t kDefaultBlockSize = 64 << 10;
+
+    explicit CommandBuffer(std::size_t block_size = kDefaultBlockSize);
+    CommandBuffer(CommandBuffer &&) noexcept = default;
+    CommandBuffer &operator=(CommandBuffer &&) noexcept = default;
+
+    void UseProgram(shader::Program &program);
+    // Set on the program of the last UseProgram. Throws std::logic_error if
+    // there was none
+    void SetUniform(shader::Uniform<GLboolean> uniform, GLboolean value);
+    void SetUniform(shader::Uniform<GLint> uniform, GLint value);
+    void SetUniform(shader::Uniform<GLfloat> uniform, GLfloat value);
+
+    void BindVertexArray(GLuint vertex_array);
+    void BindBuffer(GLenum target, GLuint buffer);
+    void BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    void Enable(GLenum capability);
+    void Disable(GLenum capability);
+
+    void DrawArrays(GLenum mode, GLint first, GLsizei count);
+    // `offset` is in bytes into the element array buffer
+    void DrawElements(GLenum mode, GLsizei count, GLenum type, std::size_t offset);
+    void DrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances);
+    void DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, std::size_t offset, GLsizei instances);
+
+    // Issues the commands in the order they were recorded, through
+    // gl::State. On the GL thread only; the buffer is left as it is
+    void Replay() const;
+    // Drops the commands and keeps the memory
+    void Clear();
+
+    [[nodiscard]] std::size_t commands() const {
+      return commands_;
+    }
+    // Bytes of commands recorded
+    [[nodiscard]] std::size_t size() const;
+
+  private:
+    enum class Opcode : std::uint8_t;
+
+    struct Block {
+      std::unique_ptr<std::byte[]> data;
+      std::size_t used;
+    };
+
+    std::size_t block_size_;
+    std::vector<Block> blocks_;
+    // Block being written; the ones after it are spare
+    std::size_t current_ = 0;
+    std::size_t commands_ = 0;
+    bool has_program_ = false;
+
+    template<typename Command>
+    void Record(Opcode opcode, const Command &command);
+    std::byte *Allocate(std::size_t size);
+};
+}
+
+#endif //COMMAND_BUFFER_H
@@ -0,0 +1,113 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <glad/glad.h>
+
+#include <embers/shader.h>
+
+namespace embers::shader {
+class ProgramCache;
+
+// A context created to share objects with the one the Compiler is used on.
+// `make_current` and `release` are called on the worker thread
+struct SharedContext {
+  std::function<void()> make_current;
+  std::function<void()> release;
+};
+
+namespace detail {
+struct CompileJob;
+}
+
+// Result of Compiler::Compile. Owns the shader until Get is called
+class ShaderFuture {
+  public:
+    ShaderFuture(ShaderFuture &&) noexcept = default;
+    ShaderFuture &operator=(ShaderFuture &&) noexcept = default;
+    ~ShaderFuture();
+
+    // Never blocks
+    [[nodiscard]] bool Ready() const;
+    // Blocks until the shader is compiled and throws ShaderException if it
+    // failed. Can be called once
+    Shader Get();
+  private:
+    friend class Compiler;
+    explicit ShaderFuture(std::shared_ptr<detail::CompileJob> job);
+    std::shared_ptr<detail::CompileJob> job_;
+};
+
+// Result of Compiler::Link and Compiler::Build. Owns the program until Get
+// is called
+class ProgramFuture {
+  public:
+    ProgramFuture(ProgramFuture &&) noexcept = default;
+    ProgramFuture &operator=(ProgramFuture &&) noexcept = default;
+    ~ProgramFuture();
+
+    // Never blocks
+    [[nodiscard]] bool Ready() const;
+    // Blocks until the program is linked and throws ShaderException if it or
+    // one of its shaders failed. Can be called once
+    Program Get();
+  private:
+    friend class Compiler;
+    explicit ProgramFuture(std::shared_ptr<detail::CompileJob> job);
+    std::shared_ptr<detail::CompileJob> job_;
+};
+
+// Submits compile and link work without waiting for it, so the driver can
+// overlap it with everything else done before the results are needed.
+//
+// With GL_KHR_parallel_shader_compile the driver compiles on its own threads
+// and the futures poll GL_COMPLETION_STATUS_KHR. Otherwise, if given a shared
+// context, the work runs on a worker thread bound to it. Without either the
+// status queries are still deferred until Get
+class Compiler {
+  public:
+    explicit Compiler(SharedContext *worker_context = nullptr);
+    Compiler(const Compiler &) = delete;
+    // Finishes every submitted job
+    ~Compiler();
+
+    [[nodiscard]] static bool DriverCompilesInParallel();
+
+    ShaderFuture Compile(const Source &source);
+    ProgramFuture Link(std::initializer_list<std::reference_wrapper<const ShaderFuture>> shaders);
+    // Compiles and links `sources`, or restores the program from `cache`
+    ProgramFuture Build(
+      std::initializer_list<std::reference_wrapper<const Source>> sources,
+      ProgramCache *cache = nullptr
+    );
+
+  private:
+    bool parallel_;
+    bool threaded_;
+    SharedContext *worker_context_;
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable queue_changed_;
+    std::deque<std::function<void()>> queue_;
+    // Jobs the worker ran, destroyed on the thread owning the compiler
+    std::vector<std::function<void()>> finished_;
+    bool stopping_ = false;
+
+    ProgramFuture SubmitLink(std::vector<std::shared_ptr<detail::CompileJob>> inputs, bool retrievable);
+    void Submit(std::function<void()> job);
+    void Work();
+};
+}
+
+#endif //COMPILER_H
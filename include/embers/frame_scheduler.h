@@ -0,0 +1,78 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+namespace embers {
+// Paces frames against absolute deadlines, so a late frame does not push
+// every later one back, and keeps the durations of recent frames
+class FrameScheduler {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Mode {
+      // Waits for the next deadline at the target rate
+      kCapped,
+      // Never waits
+      kUncapped,
+      // Never waits, buffer swaps are expected to block on vertical sync
+      kVsync,
+    };
+
+    // In milliseconds, over the frames still in the history
+    struct Statistics {
+      std::size_t frames = 0;
+      double mean = 0;
+      double p99 = 0;
+      double max = 0;
+      // Standard deviation of the frame time
+      double jitter = 0;
+      // Frames that started after their deadline, since construction
+      std::size_t missed = 0;
+    };
+
+    // The OS sleeps until `spin` before a deadline, the rest is spun, which
+    // hides the coarse granularity of sleeping. Throws std::invalid_argument
+    // unless `target_rate` is above 0
+    explicit FrameScheduler(
+      double target_rate = 60,
+      Mode mode = Mode::kCapped,
+      std::chrono::microseconds spin = std::chrono::microseconds(1500),
+      std::size_t history = 1024
+    );
+
+    // Call once per frame before its work. Waits until the frame is due and
+    // records how long the previous one took
+    void WaitForNextFrame();
+
+    void SetTargetRate(double target_rate);
+    void SetMode(Mode mode);
+    [[nodiscard]] Mode mode() const {
+      return mode_;
+    }
+
+    [[nodiscard]] Statistics statistics() const;
+    void Report(std::ostream &output) const;
+
+  private:
+    Mode mode_;
+    Clock::duration period_;
+    std::chrono::microseconds spin_;
+    Clock::time_point deadline_;
+    Clock::time_point frame_start_;
+    bool started_ = false;
+    std::size_t missed_ = 0;
+    // Ring of recent frame times
+    std::vector<Clock::duration> history_;
+    std::size_t recorded_ = 0;
+};
+}
+
+#endif //FRAME_SCHEDULER_H
@@ -0,0 +1,148 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef GL_HANDLE_H
+#define GL_HANDLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <glad/glad.h>
+
+namespace embers::gl {
+enum class Kind : std::uint8_t {
+  kBuffer,
+  kVertexArray,
+  kTexture,
+  kFramebuffer,
+  kRenderbuffer,
+  kQuery,
+  kSampler,
+  // Made by glCreateShader and glCreateProgram, so pools only delete them
+  kShader,
+  kProgram,
+};
+
+inline constexpr std::size_t kKinds = 9;
+
+// Names of one kind of GL object, for the context current on this thread,
+// like State. Names are generated in batches, and objects given back are
+// only deleted by Collect, in one call per kind, so nothing recorded for
+// later, e.g. in a CommandBuffer, refers to a deleted object.
+//
+// Queries are recycled instead of deleted, as their next use overwrites
+// them. Other objects keep state a new owner would not expect, or storage
+// that would stay allocated while the name waits for reuse
+class Pool {
+  public:
+    struct Statistics {
+      std::size_t generate_calls = 0;
+      std::size_t generated = 0;
+      std::size_t recycled = 0;
+      std::size_t delete_calls = 0;
+      std::size_t deleted = 0;
+    };
+
+    static Pool &Of(Kind kind);
+
+    Pool(const Pool &) = delete;
+    Pool &operator=(const Pool &) = delete;
+
+    // A name for a new object. Throws std::logic_error for shaders and
+    // programs, which the pool cannot create
+    GLuint Acquire();
+    // The object is deleted or recycled by the next Collect
+    void Release(GLuint name);
+
+    // Deletes or recycles the objects released since the last call
+    void Collect();
+    // Collect, then deletes the spare names too. Call before the context
+    // goes away
+    void Trim();
+
+    [[nodiscard]] const Statistics &statistics() const {
+      return statistics_;
+    }
+    void ResetStatistics() {
+      statistics_ = {};
+    }
+
+  private:
+    Kind kind_;
+    // Generated or recycled names, handed out from the back
+    std::vector<GLuint> free_;
+    std::vector<GLuint> released_;
+    Statistics statistics_;
+
+    explicit Pool(Kind kind);
+};
+
+// Collects, or trims, the pools of every kind. Call Collect once per frame
+// at a point where nothing refers to objects given back, e.g. after
+// swapping buffers
+void Collect();
+void Trim();
+
+// Owns one GL object and gives it back to its pool when destroyed
+template<Kind K>
+class Handle {
+  public:
+    Handle() = default;
+    Handle(Handle &&handle) noexcept : name_(std::exchange(handle.name_, 0)) {}
+    Handle &operator=(Handle &&handle) noexcept {
+      if (this != &handle) {
+        Reset();
+        name_ = std::exchange(handle.name_, 0);
+      }
+      return *this;
+    }
+    ~Handle() {
+      Reset();
+    }
+
+    static Handle Create() requires (K != Kind::kShader && K != Kind::kProgram) {
+      return Handle(Pool::Of(K).Acquire());
+    }
+    // Takes over an object created elsewhere, e.g. by glCreateProgram
+    static Handle Adopt(const GLuint name) {
+      return Handle(name);
+    }
+
+    void Reset() {
+      if (name_) {
+        Pool::Of(K).Release(std::exchange(name_, 0));
+      }
+    }
+    // Stops owning the object and returns it
+    GLuint Release() {
+      return std::exchange(name_, 0);
+    }
+
+    [[nodiscard]] GLuint get() const {
+      return name_;
+    }
+    explicit operator GLuint() const {
+      return name_;
+    }
+    explicit operator bool() const {
+      return name_ != 0;
+    }
+
+  private:
+    GLuint name_ = 0;
+
+    explicit Handle(const GLuint name) : name_(name) {}
+};
+
+using Buffer = Handle<Kind::kBuffer>;
+using VertexArray = Handle<Kind::kVertexArray>;
+using Texture = Handle<Kind::kTexture>;
+using Framebuffer = Handle<Kind::kFramebuffer>;
+using Renderbuffer = Handle<Kind::kRenderbuffer>;
+using Query = Handle<Kind::kQuery>;
+using Sampler = Handle<Kind::kSampler>;
+}
+
+#endif //GL_HANDLE_H
@@ -0,0 +1,92 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <glad/glad.h>
+
+namespace embers::gl {
+// Cache of the bindings and fixed-function state of a context, which skips
+// GL calls that would not change anything. Every value starts out unknown.
+//
+// There is one per thread, standing for the context current on it. After
+// switching contexts on a thread, or calling GL directly for something
+// tracked here, call Invalidate
+class State {
+  public:
+    struct Statistics {
+      // Calls skipped
+      std::size_t hits = 0;
+      // Calls made
+      std::size_t misses = 0;
+    };
+
+    static State &Current();
+
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vertex_array);
+    void BindBuffer(GLenum target, GLuint buffer);
+    // Also binds `buffer` to `target` itself, as GL does
+    void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+    // Ranges are not cached, this always calls GL
+    void BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+    void Enable(GLenum capability);
+    void Disable(GLenum capability);
+    void SetCapability(GLenum capability, bool enabled);
+    void BlendFunc(GLenum source, GLenum destination);
+    void DepthFunc(GLenum function);
+    void DepthMask(GLboolean enabled);
+    void CullFace(GLenum face);
+    void ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+    void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    // Call right before deleting the object, so a recycled name is not
+    // mistaken for the deleted one
+    void ForgetProgram(GLuint program);
+    void ForgetVertexArray(GLuint vertex_array);
+    void ForgetBuffer(GLuint buffer);
+
+    void Invalidate();
+
+    [[nodiscard]] const Statistics &statistics() const {
+      return statistics_;
+    }
+    void ResetStatistics() {
+      statistics_ = {};
+    }
+
+  private:
+    static constexpr GLuint kUnknown = ~GLuint(0);
+    static constexpr std::size_t kBufferTargets = 9;
+    static constexpr std::size_t kIndexedBindings = 36;
+    static constexpr std::size_t kCapabilities = 10;
+
+    GLuint program_;
+    GLuint vertex_array_;
+    // The element array binding is part of the vertex array, and becomes
+    // unknown whenever another vertex array is bound
+    std::array<GLuint, kBufferTargets> buffers_;
+    std::array<GLuint, kIndexedBindings> uniform_buffers_;
+    // -1 unknown, 0 disabled, 1 enabled
+    std::array<std::int8_t, kCapabilities> capabilities_;
+    std::array<GLenum, 2> blend_func_;
+    GLenum depth_func_;
+    GLint depth_mask_;
+    GLenum cull_face_;
+    std::array<GLfloat, 4> clear_color_;
+    std::array<GLint, 4> viewport_;
+    bool clear_color_known_;
+    Statistics statistics_;
+
+    State();
+    bool Hit(bool hit);
+};
+}
+
+#endif //GL_STATE_H
@@ -0,0 +1,26 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstdint>
+#include <string_view>
+
+namespace embers {
+constexpr std::uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ull;
+constexpr std::uint64_t kFnvPrime = 0x100000001b3ull;
+
+// 64-bit FNV-1a, usable at compile time. Pass a previous result as `hash` to
+// hash several pieces of data as one
+constexpr std::uint64_t Fnv1a(const std::string_view data, std::uint64_t hash = kFnvOffsetBasis) {
+  for (const char c : data) {
+    hash ^= static_cast<std::uint8_t>(c);
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+}
+
+#endif //HASH_H
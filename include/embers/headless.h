@@ -0,0 +1,68 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+
+#include <embers/compiler.h>
+
+namespace embers {
+// An OpenGL 3.3 core context without a window, for servers and CI machines
+// with no display, e.g. Mesa llvmpipe. Uses an EGL surfaceless display when
+// available and a 1x1 pbuffer otherwise, and renders into its own
+// framebuffer object of the requested size.
+//
+// The constructor makes the context current on the calling thread, loads GL
+// and binds the framebuffer. Throws std::runtime_error if any of it fails.
+// The destructor trims the gl::Pool objects of the thread, which belong to
+// this context
+class Headless {
+  public:
+    Headless(int width, int height);
+    Headless(const Headless &) = delete;
+    Headless &operator=(const Headless &) = delete;
+    ~Headless();
+
+    // A context sharing objects with this one, for Compiler's worker thread.
+    // Created on first use and destroyed with this object
+    shader::SharedContext *CompileContext();
+
+    // Waits for rendering and returns the framebuffer as RGBA rows, bottom
+    // row first
+    [[nodiscard]] std::vector<std::uint8_t> ReadPixels() const;
+
+    [[nodiscard]] int width() const {
+      return width_;
+    }
+    [[nodiscard]] int height() const {
+      return height_;
+    }
+    [[nodiscard]] GLuint framebuffer() const {
+      return framebuffer_;
+    }
+
+  private:
+    int width_;
+    int height_;
+    // EGL handles, kept opaque so users of this header need no EGL headers
+    void *display_ = nullptr;
+    void *config_ = nullptr;
+    void *context_ = nullptr;
+    void *surface_ = nullptr;
+    void *shared_context_ = nullptr;
+    void *shared_surface_ = nullptr;
+    shader::SharedContext shared_;
+    GLuint framebuffer_ = 0;
+    GLuint color_ = 0;
+    GLuint depth_stencil_ = 0;
+
+    void Release();
+};
+}
+
+#endif //HEADLESS_H
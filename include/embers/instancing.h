@@ -0,0 +1,125 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef INSTANCING_H
+#define INSTANCING_H
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <glad/glad.h>
+
+#include <embers/gl_state.h>
+#include <embers/stream_buffer.h>
+#include <embers/vertex.h>
+
+// Instanced drawing: one mesh drawn many times by one glDraw*Instanced call,
+// with per-instance attributes that advance once per instance instead of
+// once per vertex. The instances of a frame are written to an
+// InstanceStream, so each object costs a copy of its instance data:
+//
+//   stream.Begin(objects.size());
+//   for (const Object &object : objects) {
+//     stream.Push(render::Instance2D::At(object.x, object.y, 0, 1, object.color));
+//   }
+//   glDrawArraysInstanced(GL_TRIANGLES, 0, 3, stream.End());
+namespace embers::render {
+using Color = vertex::Vec<GLubyte, 4, true>;
+
+// A 2D placement and a colour, 28 bytes. The shader takes the rows of an
+// affine transform:
+//
+//   layout (location = 2) in vec3 row0;
+//   layout (location = 3) in vec3 row1;
+//   layout (location = 4) in vec4 color;
+//   vec2 position = vec2(dot(row0, vec3(aPos, 1)), dot(row1, vec3(aPos, 1)));
+struct Instance2D {
+  vertex::Vec<GLfloat, 3> row0;
+  vertex::Vec<GLfloat, 3> row1;
+  Color color;
+
+  // Scales, rotates counterclockwise by `rotation` radians, then moves to
+  // (x, y)
+  static Instance2D At(GLfloat x, GLfloat y, GLfloat rotation, GLfloat scale, Color color);
+};
+
+// A 4x4 transform and a colour, 68 bytes. The columns take four locations,
+// as a mat4 attribute does:
+//
+//   layout (location = 2) in mat4 transform;
+//   layout (location = 6) in vec4 color;
+struct Instance3D {
+  vertex::Vec<GLfloat, 4> column0;
+  vertex::Vec<GLfloat, 4> column1;
+  vertex::Vec<GLfloat, 4> column2;
+  vertex::Vec<GLfloat, 4> column3;
+  Color color;
+
+  // `matrix` is column-major, as glUniformMatrix4fv takes it
+  static Instance3D From(const GLfloat (&matrix)[16], Color color);
+};
+
+// Per-instance attributes of T, laid out as vertex.h describes, written each
+// frame into a region of a StreamBuffer. End points the attributes of
+// `vertex_array` at that region, from `first_location` on
+template<typename T>
+class InstanceStream {
+  public:
+    InstanceStream(gl::StreamBuffer &buffer, const GLuint vertex_array, const GLuint first_location)
+      : buffer_(buffer)
+    , vertex_array_(vertex_array)
+    , first_location_(first_location) {}
+    InstanceStream(const InstanceStream &) = delete;
+    InstanceStream &operator=(const InstanceStream &) = delete;
+
+    // Maps room for `capacity` instances
+    void Begin(const std::size_t capacity) {
+      data_ = nullptr;
+      capacity_ = capacity;
+      count_ = 0;
+      if (capacity > 0) {
+        const gl::StreamBuffer::Region region = buffer_.Map(static_cast<GLsizeiptr>(capacity * sizeof(T)));
+        data_ = static_cast<std::byte *>(region.data);
+        offset_ = region.offset;
+      }
+    }
+
+    // Throws std::length_error past the capacity given to Begin
+    void Push(const T &instance) {
+      if (count_ == capacity_) {
+        throw std::length_error("InstanceStream: more instances than Begin made room for");
+      }
+      std::memcpy(data_ + count_ * sizeof(T), &instance, sizeof(T));
+      ++count_;
+    }
+
+    // Unmaps the instances and binds the vertex array with its attributes
+    // pointing at them. Returns their count, for the instanced draw
+    GLsizei End() {
+      if (!data_) {
+        return 0;
+      }
+      buffer_.Unmap();
+      data_ = nullptr;
+      gl::State::Current().BindVertexArray(vertex_array_);
+      vertex::SetAttributes<T>(first_location_, buffer_.name(), vertex::Storage::kInterleaved, 0, offset_, 1);
+      return static_cast<GLsizei>(count_);
+    }
+
+    [[nodiscard]] std::size_t size() const {
+      return count_;
+    }
+
+  private:
+    gl::StreamBuffer &buffer_;
+    GLuint vertex_array_;
+    GLuint first_location_;
+    std::byte *data_ = nullptr;
+    GLintptr offset_ = 0;
+    std::size_t capacity_ = 0;
+    std::size_t count_ = 0;
+};
+}
+
+#endif //INSTANCING_H
@@ -0,0 +1,129 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace embers {
+// A fixed set of worker threads that balance work by stealing. Every worker
+// has its own deque of jobs: it pushes and pops at the back, while idle
+// workers take from the front of the others', so split work spreads out
+// with little contention.
+//
+// Work goes in through ParallelFor, which blocks until it is done, or Spawn,
+// which does not wait. The calling thread of ParallelFor runs jobs while it
+// waits, so calling ParallelFor from a job is fine
+class JobSystem {
+  public:
+    struct Statistics {
+      std::size_t jobs = 0;
+      // Jobs run by a thread other than the one that pushed them
+      std::size_t steals = 0;
+    };
+
+    // One less than the hardware threads, since the caller works too, and
+    // at least one
+    static unsigned DefaultThreads();
+
+    explicit JobSystem(unsigned threads = DefaultThreads());
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+    ~JobSystem();
+
+    // Calls `body(begin, end)` for consecutive chunks of at most `grain`
+    // items covering [0, count), on any of the threads. After every chunk
+    // ran, rethrows the first exception one of them threw
+    template<typename Body>
+    void ParallelFor(std::size_t count, std::size_t grain, Body &&body);
+
+    // Runs `task` on some thread of this system and returns right away.
+    // Tasks must not throw. The destructor runs every task still queued
+    template<typename Task>
+    void Spawn(Task &&task);
+
+    // 0 on threads outside this system, 1 + n on its worker n, e.g. to pick
+    // per-thread scratch space from an array of threads() + 1
+    [[nodiscard]] unsigned ThreadIndex() const;
+    [[nodiscard]] unsigned threads() const {
+      return static_cast<unsigned>(workers_.size());
+    }
+
+    [[nodiscard]] Statistics statistics() const {
+      return {jobs_.load(std::memory_order_relaxed), steals_.load(std::memory_order_relaxed)};
+    }
+
+  private:
+    using Function = void (*)(void *body, std::size_t begin, std::size_t end);
+
+    // One ParallelFor, on the stack of its caller
+    struct Batch {
+      std::atomic<std::size_t> pending;
+      std::atomic<bool> failed = false;
+      std::exception_ptr error;
+    };
+
+    struct Job {
+      Function function;
+      void *body;
+      std::size_t begin;
+      std::size_t end;
+      // Null for spawned tasks, which own their body
+      Batch *batch;
+    };
+
+    // Own cache lines, so workers locking their deque do not slow others
+    struct alignas(64) Queue {
+      std::mutex mutex;
+      std::deque<Job> jobs;
+    };
+
+    // Deque 0 is shared by the threads outside this system
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    // Jobs in all deques, which idle workers sleep on
+    std::atomic<std::size_t> queued_ = 0;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::atomic<std::size_t> jobs_ = 0;
+    std::atomic<std::size_t> steals_ = 0;
+
+    void Run(std::size_t count, std::size_t grain, Function function, void *body);
+    void SpawnTask(std::unique_ptr<std::function<void()>> task);
+    bool RunOne(unsigned queue);
+    void Work(unsigned queue);
+};
+
+template<typename Body>
+void JobSystem::ParallelFor(const std::size_t count, const std::size_t grain, Body &&body) {
+  using Type = std::remove_reference_t<Body>;
+  Run(
+    count,
+    grain,
+    [](void *body, const std::size_t begin, const std::size_t end) {
+      (*static_cast<Type *>(body))(begin, end);
+    },
+    const_cast<void *>(static_cast<const void *>(std::addressof(body)))
+  );
+}
+
+template<typename Task>
+void JobSystem::Spawn(Task &&task) {
+  SpawnTask(std::make_unique<std::function<void()>>(std::forward<Task>(task)));
+}
+}
+
+#endif //JOB_SYSTEM_H
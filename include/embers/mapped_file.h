@@ -0,0 +1,35 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+namespace embers {
+// Read-only memory mapping of a whole file
+class MappedFile {
+  public:
+    MappedFile() = default;
+    // Throws std::system_error if the file cannot be opened or mapped
+    explicit MappedFile(const std::filesystem::path &path);
+    MappedFile(const MappedFile &) = delete;
+    MappedFile(MappedFile &&file) noexcept;
+    ~MappedFile();
+
+    [[nodiscard]] std::string_view view() const {
+      return {data_, size_};
+    }
+
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile &operator=(MappedFile &&file) noexcept;
+  private:
+    const char *data_ = nullptr;
+    std::size_t size_ = 0;
+};
+}
+
+#endif //MAPPED_FILE_H
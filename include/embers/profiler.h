@@ -0,0 +1,170 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <glad/glad.h>
+
+namespace embers::profile {
+// Collects timed zones of CPU and GPU work, per zone statistics and a trace
+// that chrome://tracing or Perfetto can open. Zones are named by string
+// literals, or other strings that outlive the profiler.
+//
+// GPU zones are timestamp queries read back a few frames later, and only
+// once the GPU reports them available, so profiling never waits for the GPU.
+// Everything is off until Enable is called, leaving zones nearly free
+class Profiler {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    // In milliseconds
+    struct ZoneStatistics {
+      std::string_view name;
+      bool gpu;
+      std::size_t count;
+      double total;
+      double mean;
+      double max;
+    };
+
+    // The one instance zones report to
+    static Profiler &Global();
+
+    // `latency` is how many frames GPU results are left alone before they
+    // are checked. At most `max_events` trace events are kept
+    explicit Profiler(unsigned latency = 3, std::size_t max_events = 1 << 20);
+    Profiler(const Profiler &) = delete;
+
+    // Drops everything recorded and frees the queries. Call on the GL thread
+    // before its context goes away; the destructor leaves GL alone
+    void Reset();
+
+    void Enable(bool enabled = true);
+    [[nodiscard]] bool enabled() const {
+      return enabled_.load(std::memory_order_relaxed);
+    }
+
+    // Thread-safe
+    void RecordCpu(std::string_view name, Clock::time_point start, Clock::time_point end);
+
+    // On the GL thread only. The returned id is passed to EndGpu
+    std::size_t BeginGpu(std::string_view name);
+    void EndGpu(std::size_t zone);
+
+    // Call once per frame on the GL thread. Reads back the GPU zones that
+    // are done, without waiting for the others
+    void EndFrame();
+
+    [[nodiscard]] std::vector<ZoneStatistics> statistics() const;
+    void Report(std::ostream &output) const;
+    // Chrome trace event format, one complete event per zone
+    void WriteTrace(std::ostream &output) const;
+
+  private:
+    struct Accumulator {
+      std::size_t count = 0;
+      Clock::duration total{};
+      Clock::duration max{};
+    };
+
+    struct Event {
+      std::string_view name;
+      // 0 for the GPU, threads count up from 1
+      std::uint32_t track;
+      // Since the profiler was created
+      Clock::duration start;
+      Clock::duration duration;
+    };
+
+    struct PendingGpuZone {
+      std::string_view name;
+      GLuint begin;
+      GLuint end;
+      std::uint64_t frame;
+      bool ended;
+    };
+
+    unsigned latency_;
+    std::size_t max_events_;
+    std::atomic<bool> enabled_ = false;
+    Clock::time_point epoch_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string_view, Accumulator> cpu_zones_;
+    std::unordered_map<std::string_view, Accumulator> gpu_zones_;
+    std::unordered_map<std::thread::id, std::uint32_t> tracks_;
+    std::vector<Event> events_;
+    std::size_t dropped_events_ = 0;
+
+    // GL thread only
+    std::uint64_t frame_ = 0;
+    // Zones by id, in the order they began; the front has id `first_gpu_zone_`
+    std::deque<PendingGpuZone> gpu_pending_;
+    std::size_t first_gpu_zone_ = 0;
+    std::vector<GLuint> free_queries_;
+    std::vector<GLuint> all_queries_;
+    // GPU timestamp taken at `gpu_calibration_cpu_`, to place GPU zones on
+    // the CPU timeline
+    GLint64 gpu_calibration_ = -1;
+    Clock::time_point gpu_calibration_cpu_;
+
+    GLuint AcquireQuery();
+    void Record(std::unordered_map<std::string_view, Accumulator> &zones, const Event &event);
+};
+
+// Times the enclosing scope on the CPU
+class CpuZone {
+  public:
+    explicit CpuZone(const std::string_view name)
+      : name_(name)
+    , enabled_(Profiler::Global().enabled()) {
+      if (enabled_) {
+        start_ = Profiler::Clock::now();
+      }
+    }
+    CpuZone(const CpuZone &) = delete;
+    ~CpuZone() {
+      if (enabled_) {
+        Profiler::Global().RecordCpu(name_, start_, Profiler::Clock::now());
+      }
+    }
+
+  private:
+    std::string_view name_;
+    bool enabled_;
+    Profiler::Clock::time_point start_;
+};
+
+// Times the GL commands issued in the enclosing scope on the GPU
+class GpuZone {
+  public:
+    explicit GpuZone(const std::string_view name)
+      : enabled_(Profiler::Global().enabled())
+    , zone_(enabled_ ? Profiler::Global().BeginGpu(name) : 0) {}
+    GpuZone(const GpuZone &) = delete;
+    ~GpuZone() {
+      if (enabled_) {
+        Profiler::Global().EndGpu(zone_);
+      }
+    }
+
+  private:
+    bool enabled_;
+    std::size_t zone_;
+};
+}
+
+#endif //PROFILER_H
@@ -0,0 +1,61 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <span>
+#include <glad/glad.h>
+
+namespace embers::shader {
+class Source;
+
+// On-disk cache of linked program binaries. A program is keyed by the text
+// and stage of every attached Source plus the driver that produced it, so a
+// driver update invalidates the whole cache. Needs a current context to be
+// constructed, and does nothing when the driver has no binary formats
+class ProgramCache {
+  public:
+    struct Statistics {
+      std::size_t hits = 0;
+      std::size_t misses = 0;
+      // Binaries found on disk but refused by the driver
+      std::size_t rejected = 0;
+      std::chrono::nanoseconds hit_time{};
+      std::chrono::nanoseconds miss_time{};
+    };
+
+    explicit ProgramCache(std::filesystem::path directory);
+    ProgramCache(const ProgramCache &) = delete;
+
+    [[nodiscard]] bool IsSupported() const {
+      return supported_;
+    }
+    [[nodiscard]] std::uint64_t Key(std::span<const Source *const> sources) const;
+
+    // Returns true if a stored binary was accepted and `program` is linked
+    bool Load(GLuint program, std::uint64_t key);
+    void Store(GLuint program, std::uint64_t key) const;
+    void Record(bool hit, std::chrono::nanoseconds time);
+
+    [[nodiscard]] const Statistics &statistics() const {
+      return statistics_;
+    }
+    void Report(std::ostream &output) const;
+
+  private:
+    std::filesystem::path directory_;
+    std::uint64_t driver_hash_;
+    bool supported_;
+    Statistics statistics_;
+
+    [[nodiscard]] std::filesystem::path PathOf(std::uint64_t key) const;
+};
+}
+
+#endif //PROGRAM_CACHE_H
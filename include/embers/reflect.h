@@ -0,0 +1,115 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef REFLECT_H
+#define REFLECT_H
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Compile-time access to the fields of plain aggregates, which C++ has no
+// reflection for. Fields are counted by how many initializers the aggregate
+// accepts and reached through structured bindings
+namespace embers::reflect {
+namespace detail {
+// Stands in for an initializer of any field. Never evaluated
+struct AnyField {
+  template<typename T>
+  constexpr operator T() const;
+};
+
+template<typename T, typename... Fields>
+constexpr std::size_t CountFields() {
+  if constexpr (requires { T{std::declval<Fields>()..., std::declval<AnyField>()}; }) {
+    return CountFields<T, Fields..., AnyField>();
+  } else {
+    return sizeof...(Fields);
+  }
+}
+}
+
+// Supported aggregates have at most this many fields, none of them a C array
+// or a base class
+inline constexpr std::size_t kMaxFields = 16;
+
+template<typename T>
+concept Reflectable = std::is_aggregate_v<T> && !std::is_array_v<T>;
+
+template<Reflectable T>
+inline constexpr std::size_t kFieldCount = detail::CountFields<T>();
+
+// Tuple of references to the fields of `value`, in declaration order
+template<typename T>
+  requires Reflectable<std::remove_const_t<T>>
+constexpr auto Tie(T &value) {
+  constexpr std::size_t kFields = kFieldCount<std::remove_const_t<T>>;
+  static_assert(kFields > 0 && kFields <= kMaxFields, "unsupported number of fields");
+  if constexpr (kFields == 1) {
+    auto &[f0] = value;
+    return std::tie(f0);
+  } else if constexpr (kFields == 2) {
+    auto &[f0, f1] = value;
+    return std::tie(f0, f1);
+  } else if constexpr (kFields == 3) {
+    auto &[f0, f1, f2] = value;
+    return std::tie(f0, f1, f2);
+  } else if constexpr (kFields == 4) {
+    auto &[f0, f1, f2, f3] = value;
+    return std::tie(f0, f1, f2, f3);
+  } else if constexpr (kFields == 5) {
+    auto &[f0, f1, f2, f3, f4] = value;
+    return std::tie(f0, f1, f2, f3, f4);
+  } else if constexpr (kFields == 6) {
+    auto &[f0, f1, f2, f3, f4, f5] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5);
+  } else if constexpr (kFields == 7) {
+    auto &[f0, f1, f2, f3, f4, f5, f6] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6);
+  } else if constexpr (kFields == 8) {
+    auto &[f0, f1, f2, f3, f4, f5, f6, f7] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7);
+  } else if constexpr (kFields == 9) {
+    auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8);
+  } else if constexpr (kFields == 10) {
+    auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9);
+  } else if constexpr (kFields == 11) {
+    auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10);
+  } else if constexpr (kFields == 12) {
+    auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11);
+  } else if constexpr (kFields == 13) {
+    auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12);
+  } else if constexpr (kFields == 14) {
+    auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13);
+  } else if constexpr (kFields == 15) {
+    auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14);
+  } else if constexpr (kFields == 16) {
+    auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15] = value;
+    return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15);
+  }
+}
+
+namespace detail {
+template<typename References, std::size_t... I>
+std::tuple<std::remove_reference_t<std::tuple_element_t<I, References>>...> Values(std::index_sequence<I...>);
+}
+
+template<Reflectable T>
+using FieldTypes = decltype(detail::Values<decltype(Tie(std::declval<T &>()))>(
+  std::make_index_sequence<kFieldCount<T>>()
+));
+
+template<Reflectable T, std::size_t I>
+using FieldType = std::tuple_element_t<I, FieldTypes<T>>;
+}
+
+#endif //REFLECT_H
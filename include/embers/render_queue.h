@@ -0,0 +1,159 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <glad/glad.h>
+
+#include <embers/shader.h>
+
+namespace embers::render {
+// A value for one uniform of the program a draw uses
+class UniformValue {
+  public:
+    UniformValue(shader::Uniform<GLboolean> uniform, GLboolean value);
+    UniformValue(shader::Uniform<GLint> uniform, GLint value);
+    UniformValue(shader::Uniform<GLfloat> uniform, GLfloat value);
+
+    void Apply(shader::Program &program) const;
+    [[nodiscard]] std::uint64_t hash() const;
+
+    friend bool operator==(const UniformValue &, const UniformValue &) = default;
+
+  private:
+    std::variant<
+      std::pair<shader::Uniform<GLboolean>, GLboolean>,
+      std::pair<shader::Uniform<GLint>, GLint>,
+      std::pair<shader::Uniform<GLfloat>, GLfloat>
+    > value_;
+};
+
+// Identifies uniform values registered with Queue::Uniforms until the next
+// Submit
+using UniformSet = std::uint16_t;
+inline constexpr UniformSet kNoUniforms = 0;
+
+// Collects the draws of a frame and submits them sorted by the state they
+// need, so each program, vertex array and set of uniform values is bound
+// once per run of draws using it. Draws that share all of it are merged into
+// one glMultiDrawArrays or glMultiDrawElements call.
+//
+// Draws with the same state keep the order they were pushed in; there is no
+// order between draws with different state
+class Queue {
+  public:
+    struct Statistics {
+      std::size_t packets = 0;
+      // GL draw calls the packets were merged into
+      std::size_t draw_calls = 0;
+      std::size_t program_changes = 0;
+      std::size_t vertex_array_changes = 0;
+      std::size_t uniform_changes = 0;
+    };
+
+    // At most this many distinct programs, vertex arrays and uniform sets,
+    // and this many draws, between two calls to Submit
+    static constexpr std::size_t kMaxPrograms = 1 << 12;
+    static constexpr std::size_t kMaxVertexArrays = 1 << 12;
+    static constexpr std::size_t kMaxUniformSets = (1 << 14) - 1;
+    static constexpr std::size_t kMaxPackets = 1 << 20;
+
+    // Values equal to those of an earlier set, in the same order, give back
+    // that set
+    UniformSet Uniforms(std::initializer_list<UniformValue> values);
+
+    // `program` has to outlive the next Submit. `uniforms` are applied to it
+    // before drawing
+    void DrawArrays(
+      shader::Program &program,
+      GLuint vertex_array,
+      GLenum mode,
+      GLint first,
+      GLsizei count,
+      UniformSet uniforms = kNoUniforms
+    );
+    // `offset` is in bytes into the element array buffer of `vertex_array`
+    void DrawElements(
+      shader::Program &program,
+      GLuint vertex_array,
+      GLenum mode,
+      GLsizei count,
+      GLenum type,
+      std::size_t offset,
+      UniformSet uniforms = kNoUniforms
+    );
+
+    // Draws everything pushed since the last call and empties the queue
+    void Submit();
+
+    [[nodiscard]] const Statistics &statistics() const {
+      return statistics_;
+    }
+    void ResetStatistics() {
+      statistics_ = {};
+    }
+
+  private:
+    struct Packet {
+      // First vertex, or byte offset of the first index
+      std::intptr_t start;
+      GLsizei count;
+    };
+
+    struct Range {
+      std::uint32_t begin;
+      std::uint32_t end;
+    };
+
+    // Sort keys, with the state a draw needs in the high bits and the index
+    // of its packet in the low ones
+    std::vector<std::uint64_t> keys_;
+    // Second buffer of the radix sort
+    std::vector<std::uint64_t> scratch_;
+    std::vector<Packet> packets_;
+
+    // Dense slots for the objects seen since the last Submit, so they fit
+    // in a key
+    std::vector<shader::Program *> programs_;
+    std::unordered_map<shader::Program *, std::uint32_t> program_slots_;
+    std::vector<GLuint> vertex_arrays_;
+    std::unordered_map<GLuint, std::uint32_t> vertex_array_slots_;
+
+    std::vector<UniformValue> uniform_values_;
+    // Set n is at index n - 1
+    std::vector<Range> uniform_sets_;
+    std::unordered_multimap<std::uint64_t, UniformSet> uniform_set_hashes_;
+    // Set last applied to each program during Submit
+    std::vector<UniformSet> applied_;
+
+    // Arguments of the multi-draw call being gathered
+    std::vector<GLint> firsts_;
+    std::vector<GLsizei> counts_;
+    std::vector<const void *> offsets_;
+
+    Statistics statistics_;
+
+    void Push(
+      shader::Program &program,
+      GLuint vertex_array,
+      GLenum mode,
+      GLenum type,
+      std::intptr_t start,
+      GLsizei count,
+      UniformSet uniforms
+    );
+    void Sort();
+    void Draw(GLenum mode, GLenum type);
+};
+}
+
+#endif //RENDER_QUEUE_H
@@ -5,13 +5,24 @@
 #ifndef SHADER_H
 #define SHADER_H
 
-#include <set>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
 #include <bits/unique_ptr.h>
 #include <glad/glad.h>
 
+#include <embers/gl_handle.h>
+#include <embers/hash.h>
+#include <embers/mapped_file.h>
+
 namespace embers::shader {
 class Shader;
+class ProgramCache;
 
 enum Type {
   kVertex   = GL_VERTEX_SHADER,
@@ -24,65 +35,214 @@ class ShaderException final: public std::runtime_error {
     [[nodiscard]] const char *what() const noexcept override;
 };
 
+// GLSL text of one shader stage, kept as a list of fragments that are passed
+// to glShaderSource as they are, without joining them
 class Source {
   public:
+    // Copies `source`
     Source(const char *source, Type type, size_t length = 0);
     Source(std::istream &input_stream, Type type, size_t length = 0);
     Source(const Source &) = delete;
+    Source(Source &&source) noexcept = default;
+
+    // Neither copies the text, which has to outlive the Source
+    static Source Borrow(std::string_view source, Type type);
+    static Source Borrow(std::span<const std::string_view> fragments, Type type);
+    // Maps the file into memory instead of reading it
+    static Source Map(const std::filesystem::path &path, Type type);
+
     [[nodiscard]] Shader Compile() const;
+    // Sets every fragment as the source of `shader`
+    void Upload(GLuint shader) const;
+    [[nodiscard]] std::string Join() const;
+
+    [[nodiscard]] std::size_t fragment_count() const {
+      return strings_.size();
+    }
+    [[nodiscard]] std::string_view fragment(const std::size_t index) const {
+      return {strings_[index], static_cast<std::size_t>(lengths_[index])};
+    }
+    [[nodiscard]] Type type() const {
+      return type_;
+    }
   private:
+    // Parallel arrays, in the form glShaderSource takes them
+    std::vector<const GLchar *> strings_;
+    std::vector<GLint> lengths_;
+    // Whatever the fragments point into, unless they are borrowed
     std::unique_ptr<char[]> source_;
+    MappedFile mapping_;
     Type type_;
 
+    explicit Source(Type type);
+    void Append(std::string_view fragment);
+
     static std::unique_ptr<char[]> ReadAllFromStream(std::istream &input_stream);
 };
 
+// Deleted by gl::Collect once destroyed, see gl::Pool
 class Shader {
   public:
     explicit Shader(GLuint shader = 0);
     Shader(const Shader &) = delete;
-    ~Shader();
+    Shader(Shader &&shader) noexcept = default;
+    Shader &operator=(Shader &&shader) noexcept = default;
     explicit operator GLuint() const {
-      return shader_;
+      return shader_.get();
+    }
+  private:
+    gl::Handle<gl::Kind::kShader> shader_;
+};
+
+// Name of a uniform reduced to its hash, so the string never reaches the
+// driver. Built from a literal with `_uniform` it is hashed at compile time
+class UniformName {
+  public:
+    constexpr explicit UniformName(const std::string_view name) : hash_(Fnv1a(name)) {}
+    [[nodiscard]] constexpr std::uint64_t hash() const {
+      return hash_;
     }
   private:
-    GLuint shader_;
+    std::uint64_t hash_;
+};
+
+inline namespace literals {
+consteval UniformName operator""_uniform(const char *name, const size_t length) {
+  return UniformName(std::string_view(name, length));
+}
+}
+
+// Typed handle to an active uniform of one Program, obtained once with
+// Program::uniform and then used on the hot path instead of a name. It is
+// only valid on the Program that produced it, and a default constructed
+// handle is not valid on any
+template<typename T>
+class Uniform {
+  public:
+    Uniform() = default;
+    friend bool operator==(Uniform, Uniform) = default;
+  private:
+    friend class Program;
+    static constexpr std::uint32_t kInvalid = UINT32_MAX;
+    explicit Uniform(const std::uint32_t index) : index_(index) {}
+    std::uint32_t index_ = kInvalid;
 };
 
+// Deleted by gl::Collect once destroyed, see gl::Pool
 class Program {
   public:
     class Builder {
-      GLint program_;
-      std::set<GLuint> attached_shaders_;
-      bool is_built_ = false;
+      public:
+        // Shaders and sources attached at once, each. More throw
+        // std::length_error
+        static constexpr std::size_t kMaxAttached = 8;
+      private:
+        gl::Handle<gl::Kind::kProgram> program_;
+        std::array<GLuint, kMaxAttached> attached_shaders_{};
+        std::array<const Source *, kMaxAttached> attached_sources_{};
+        std::uint8_t attached_shader_count_ = 0;
+        std::uint8_t attached_source_count_ = 0;
+        ProgramCache *cache_ = nullptr;
       public:
         Builder();
         Builder &AttachShader(Shader &shader);
         Builder &DetachShader(Shader &shader);
+        // The source is compiled by Link, unless the program comes from the
+        // cache. It has to outlive the call to Link
+        Builder &AttachSource(const Source &source);
+        // Only programs built purely from attached sources are cached
+        Builder &UseCache(ProgramCache &cache);
         Program Link();
-        ~Builder();
     };
   private:
-    GLint program_;
+    struct UniformInfo {
+      std::uint64_t hash;
+      GLint location;
+      GLenum type;
+      GLint size;
+      // Gone or changed type in a Reload. Kept for the handles to it, which
+      // write to location -1, but no longer found by name
+      bool retired = false;
+    };
+
+    struct UniformBlockInfo {
+      std::uint64_t hash;
+      GLuint index;
+      GLint size;
+      // Set by BindUniformBlock, -1 until then
+      GLint binding;
+    };
+
+    gl::Handle<gl::Kind::kProgram> program_;
+    // Active uniforms queried once at link time; handles index into it
+    std::vector<UniformInfo> uniforms_;
+    std::vector<UniformBlockInfo> uniform_blocks_;
+
+    static std::vector<UniformInfo> ReflectUniforms(GLint program);
+    static std::vector<UniformBlockInfo> ReflectUniformBlocks(GLint program);
+    [[nodiscard]] std::uint32_t FindUniform(UniformName name, bool (*accepts)(GLenum type)) const;
+    [[nodiscard]] GLint UniformLocation(std::uint32_t index) const;
+    static bool AcceptsBoolean(GLenum type);
+    static bool AcceptsInt(GLenum type);
+    static bool AcceptsFloat(GLenum type);
   public:
     explicit Program(GLint program = 0);
     Program(const Program &) = delete;
-    Program(Program &&program) noexcept;
-    ~Program();
+    Program(Program &&program) noexcept = default;
 
     Program &use();
 
+    // Takes over the GL program of `program`, e.g. after editing its
+    // sources. Handles obtained from this Program stay valid; those whose
+    // uniform is gone or changed type are ignored by setUniform from now on,
+    // and looking such a uniform up throws as for any unknown name
+    Program &Reload(Program &&program);
+
+    // Throws ShaderException if the program has no active uniform `name`
+    // or its GLSL type cannot be set from T
+    template<typename T>
+    [[nodiscard]] Uniform<T> uniform(UniformName name) const;
+
+    // Throw ShaderException for a handle this Program cannot have produced,
+    // e.g. a default constructed one. A handle from another Program is not
+    // always caught
+    Program &setUniform(Uniform<GLboolean> uniform, GLboolean value);
+    Program &setUniform(Uniform<GLint> uniform, GLint value);
+    Program &setUniform(Uniform<GLfloat> uniform, GLfloat value);
+
+    // Connects the uniform block `name` to a uniform buffer binding point,
+    // which Reload keeps. Throws ShaderException if the program has no such
+    // block, or if it needs more than `size` bytes when `size` is given
+    Program &BindUniformBlock(UniformName name, GLuint binding, GLsizeiptr size = 0);
+    [[nodiscard]] bool HasUniformBlock(UniformName name) const;
+
+    // Convenience overloads that look the name up on every call
     Program &setUniform(const char *name, GLboolean value);
     Program &setUniform(const char *name, GLint value);
     Program &setUniform(const char *name, GLfloat value);
 
     explicit operator GLuint() const {
-      return program_;
+      return program_.get();
     }
 
   Program &operator=(const Program &) = delete;
-  Program &operator=(Program &&program) noexcept;
+  Program &operator=(Program &&program) noexcept = default;
 };
+
+template<>
+inline Uniform<GLboolean> Program::uniform<GLboolean>(const UniformName name) const {
+  return Uniform<GLboolean>(FindUniform(name, AcceptsBoolean));
+}
+
+template<>
+inline Uniform<GLint> Program::uniform<GLint>(const UniformName name) const {
+  return Uniform<GLint>(FindUniform(name, AcceptsInt));
+}
+
+template<>
+inline Uniform<GLfloat> Program::uniform<GLfloat>(const UniformName name) const {
+  return Uniform<GLfloat>(FindUniform(name, AcceptsFloat));
+}
 }
 
 #endif //SHADER_H
@@ -0,0 +1,77 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef SHADER_LIBRARY_H
+#define SHADER_LIBRARY_H
+
+#include <filesystem>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <embers/mapped_file.h>
+#include <embers/shader.h>
+
+namespace embers::shader {
+// Shader files with `#include "name"` resolved and `#define` variants put
+// together from fragments the library keeps, so every variant shares the
+// same text. Sources handed out borrow from the library, which has to
+// outlive them
+class Library {
+  public:
+    // Files not added by name are mapped from `root`
+    explicit Library(std::filesystem::path root = {});
+    Library(const Library &) = delete;
+
+    // Makes `text` available as `name` without copying it
+    void Add(const std::string &name, std::string_view text);
+
+    // Each define is "NAME" or "NAME=VALUE" and goes right after `#version`.
+    // Throws ShaderException for missing files and include cycles
+    Source Load(const std::string &name, Type type, std::span<const std::string_view> defines = {});
+    Source Load(const std::string &name, Type type, std::initializer_list<std::string_view> defines);
+
+    // Drops what is known about the file `name` and everything including it,
+    // so the next Load reads it again. Sources loaded from it before must
+    // not be used anymore
+    void Invalidate(const std::string &name);
+    // Names of the files on disk `name` is built from, itself included.
+    // Names are normalized, like every name the library keeps
+    [[nodiscard]] std::vector<std::string> FilesOf(const std::string &name);
+
+    [[nodiscard]] const std::filesystem::path &root() const {
+      return root_;
+    }
+
+  private:
+    struct File {
+      std::string_view text;
+      MappedFile mapping;
+      bool on_disk = false;
+      // Normalized names included directly
+      std::vector<std::string> includes;
+      // Names of the files that included this one when they were resolved
+      std::vector<std::string> includers;
+      // Text with its includes spliced in, as views into other files
+      std::vector<std::string_view> fragments;
+      bool resolved = false;
+      bool resolving = false;
+    };
+
+    std::filesystem::path root_;
+    std::unordered_map<std::string, File> files_;
+    // `#define` lines of every variant requested so far
+    std::unordered_map<std::string, std::string> define_blocks_;
+
+    // Both take a normalized name
+    File &Open(const std::string &name);
+    File &Resolve(const std::string &name);
+    std::string_view DefineBlock(std::span<const std::string_view> defines);
+};
+}
+
+#endif //SHADER_LIBRARY_H
@@ -0,0 +1,74 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef SHADER_WATCHER_H
+#define SHADER_WATCHER_H
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <embers/shader.h>
+#include <embers/shader_library.h>
+
+namespace embers::shader {
+// Rebuilds programs when the files they are made of change on disk, using
+// inotify. Only programs depending on a changed file are rebuilt, and a
+// program that fails to build keeps running its previous version
+class Watcher {
+  public:
+    struct Stage {
+      std::string name;
+      Type type;
+      std::vector<std::string> defines;
+    };
+
+    // Failed rebuilds are reported to `log`
+    explicit Watcher(Library &library, std::ostream &log = std::cerr);
+    Watcher(const Watcher &) = delete;
+    ~Watcher();
+
+    // `program` has to stay at the same address until it is unwatched
+    void Watch(Program &program, std::vector<Stage> stages);
+    void Unwatch(const Program &program);
+
+    // Never blocks. Call between frames on the thread owning the context;
+    // returns the number of programs reloaded
+    std::size_t Poll();
+
+  private:
+    struct Entry {
+      Program *program;
+      std::vector<Stage> stages;
+      std::vector<std::string> files;
+    };
+
+    Library &library_;
+    std::ostream &log_;
+    int inotify_;
+    std::vector<std::unique_ptr<Entry>> entries_;
+    // Normalized file path, relative to the library root and as the library
+    // names the file, to the programs built from it
+    std::unordered_map<std::string, std::vector<Entry *>> dependents_;
+    struct DirectoryWatch {
+      int descriptor;
+      // Files in `dependents_` from the directory, which is unwatched once
+      // none are left
+      std::size_t files;
+    };
+
+    // Watch descriptor to the watched directory, relative to the library root
+    std::unordered_map<int, std::string> directories_;
+    std::unordered_map<std::string, DirectoryWatch> watches_;
+
+    // Add or remove `entry` as a dependent of `files`
+    void Index(Entry &entry, const std::vector<std::string> &files);
+    void Unindex(const Entry &entry, const std::vector<std::string> &files);
+    bool Rebuild(Entry &entry);
+};
+}
+
+#endif //SHADER_WATCHER_H
@@ -0,0 +1,190 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef STD140_H
+#define STD140_H
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <glad/glad.h>
+
+#include <embers/reflect.h>
+
+// C++ types laid out like their GLSL counterparts in a std140 uniform block.
+// Blocks are mirrored by plain structs of these, GLfloat, GLint and GLuint:
+//
+//   struct Camera {
+//     std140::Mat4 view_projection;
+//     std140::Vec3 position;
+//     std140::Vec3 direction;
+//   };
+//   static_assert(std140::kMatches<Camera>);
+//
+// A scalar cannot follow a Vec3 directly, as C++ rounds the size of the Vec3
+// up to its alignment while std140 lets the scalar take the last four bytes
+namespace embers::std140 {
+template<typename T, int N>
+struct alignas(N == 2 ? 8 : 16) Vector {
+  static_assert(N >= 2 && N <= 4, "vectors have 2 to 4 components");
+  T value[N];
+
+  constexpr T &operator[](const std::size_t i) {
+    return value[i];
+  }
+  constexpr const T &operator[](const std::size_t i) const {
+    return value[i];
+  }
+};
+
+using Vec2 = Vector<GLfloat, 2>;
+using Vec3 = Vector<GLfloat, 3>;
+using Vec4 = Vector<GLfloat, 4>;
+using IVec2 = Vector<GLint, 2>;
+using IVec3 = Vector<GLint, 3>;
+using IVec4 = Vector<GLint, 4>;
+using UVec2 = Vector<GLuint, 2>;
+using UVec3 = Vector<GLuint, 3>;
+using UVec4 = Vector<GLuint, 4>;
+
+// Column-major, each column padded to a Vec4
+template<int N>
+struct alignas(16) Matrix {
+  static_assert(N >= 2 && N <= 4, "matrices have 2 to 4 columns");
+  Vec4 columns[N];
+
+  constexpr Vec4 &operator[](const std::size_t column) {
+    return columns[column];
+  }
+  constexpr const Vec4 &operator[](const std::size_t column) const {
+    return columns[column];
+  }
+};
+
+using Mat2 = Matrix<2>;
+using Mat3 = Matrix<3>;
+using Mat4 = Matrix<4>;
+
+// Elements of std140 arrays start on 16-byte boundaries
+template<typename T>
+struct alignas(16) Padded {
+  T value;
+};
+
+template<typename T, std::size_t N>
+struct Array {
+  Padded<T> elements[N];
+
+  constexpr T &operator[](const std::size_t i) {
+    return elements[i].value;
+  }
+  constexpr const T &operator[](const std::size_t i) const {
+    return elements[i].value;
+  }
+  [[nodiscard]] static constexpr std::size_t size() {
+    return N;
+  }
+};
+
+namespace detail {
+constexpr std::size_t AlignUp(const std::size_t offset, const std::size_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+// Base alignment and size under std140, and whether the C++ layout of the
+// type agrees with it. Structs are checked field by field
+template<typename T>
+struct Rules;
+
+// Aggregates above that stand for one GLSL type rather than a struct
+template<typename T>
+inline constexpr bool kIsStruct = reflect::Reflectable<T>;
+template<typename T, int N>
+inline constexpr bool kIsStruct<Vector<T, N>> = false;
+template<int N>
+inline constexpr bool kIsStruct<Matrix<N>> = false;
+template<typename T, std::size_t N>
+inline constexpr bool kIsStruct<Array<T, N>> = false;
+
+template<typename T>
+  requires std::is_same_v<T, GLfloat> || std::is_same_v<T, GLint> || std::is_same_v<T, GLuint>
+struct Rules<T> {
+  static constexpr std::size_t kAlignment = 4;
+  static constexpr std::size_t kSize = 4;
+  static constexpr bool kMatches = true;
+};
+
+template<typename T, int N>
+struct Rules<Vector<T, N>> {
+  static constexpr std::size_t kAlignment = N == 2 ? 8 : 16;
+  static constexpr std::size_t kSize = N * 4;
+  static constexpr bool kMatches = Rules<T>::kMatches;
+};
+
+template<int N>
+struct Rules<Matrix<N>> {
+  static constexpr std::size_t kAlignment = 16;
+  static constexpr std::size_t kSize = N * 16;
+  static constexpr bool kMatches = true;
+};
+
+template<typename T, std::size_t N>
+struct Rules<Array<T, N>> {
+  static constexpr std::size_t kAlignment = 16;
+  static constexpr std::size_t kSize = N * AlignUp(Rules<T>::kSize, 16);
+  static constexpr bool kMatches = Rules<T>::kMatches && sizeof(Padded<T>) == AlignUp(Rules<T>::kSize, 16);
+};
+
+template<typename T, std::size_t... I>
+constexpr bool FieldsMatch(std::index_sequence<I...>) {
+  bool matches = true;
+  std::size_t offset = 0;
+  std::size_t std140_offset = 0;
+  (
+    [&] {
+      using Field = reflect::FieldType<T, I>;
+      offset = AlignUp(offset, alignof(Field));
+      std140_offset = AlignUp(std140_offset, Rules<Field>::kAlignment);
+      matches = matches && Rules<Field>::kMatches && offset == std140_offset;
+      offset += sizeof(Field);
+      std140_offset += Rules<Field>::kSize;
+    }(),
+    ...
+  );
+  // The C++ size confirms the offsets were derived right
+  return matches && AlignUp(offset, alignof(T)) == sizeof(T);
+}
+
+template<typename T>
+constexpr std::size_t FieldsSize() {
+  std::size_t size = 0;
+  [&]<std::size_t... I>(std::index_sequence<I...>) {
+    ((size = AlignUp(size, Rules<reflect::FieldType<T, I>>::kAlignment) + Rules<reflect::FieldType<T, I>>::kSize), ...);
+  }(std::make_index_sequence<reflect::kFieldCount<T>>());
+  return size;
+}
+
+// Nested structs are aligned and padded to 16 bytes
+template<typename T>
+  requires kIsStruct<T>
+struct Rules<T> {
+  static constexpr std::size_t kAlignment = 16;
+  static constexpr std::size_t kSize = AlignUp(FieldsSize<T>(), 16);
+  static constexpr bool kMatches =
+    alignof(T) == 16 && FieldsMatch<T>(std::make_index_sequence<reflect::kFieldCount<T>>());
+};
+}
+
+// Whether the C++ layout of T is the std140 layout of the block it mirrors.
+// Top-level structs need no particular alignment, nested ones alignas(16)
+template<typename T>
+inline constexpr bool kMatches = detail::FieldsMatch<T>(std::make_index_sequence<reflect::kFieldCount<T>>());
+
+// Bytes of a uniform buffer holding T, rounded up like some drivers report
+// the block size
+template<typename T>
+inline constexpr std::size_t kBufferSize = detail::AlignUp(sizeof(T), 16);
+}
+
+#endif //STD140_H
@@ -0,0 +1,102 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <ostream>
+#include <glad/glad.h>
+
+#include <embers/gl_handle.h>
+
+namespace embers::gl {
+// One buffer object used as a ring of per-frame regions for data the CPU
+// writes every frame, e.g. dynamic vertices or uniforms.
+//
+// Regions are mapped unsynchronized, so the driver never waits for or copies
+// the buffer behind our back. Instead the regions of each frame are fenced
+// by EndFrame, and a region is only handed out again once the GPU is past
+// the fence of the frame that last used it
+class StreamBuffer {
+  public:
+    struct Statistics {
+      std::size_t allocations = 0;
+      std::size_t bytes = 0;
+      // Times the ring went back to the start of the buffer
+      std::size_t wraps = 0;
+      // Allocations that had to wait for the GPU, and how long they waited.
+      // A ring that stalls is too small for the data streamed through it
+      std::size_t stalls = 0;
+      std::chrono::nanoseconds stall_time{};
+    };
+
+    // Memory mapped for writing. `offset` is where it starts in the buffer
+    struct Region {
+      void *data;
+      GLintptr offset;
+      GLsizeiptr size;
+    };
+
+    // `target` is what Bind binds the buffer to
+    StreamBuffer(GLenum target, GLsizeiptr size);
+    StreamBuffer(const StreamBuffer &) = delete;
+    StreamBuffer &operator=(const StreamBuffer &) = delete;
+    ~StreamBuffer();
+
+    // Maps the next `size` bytes aligned to `alignment`, e.g. to
+    // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT. Waits for the GPU if they are still
+    // in use. Only one region is mapped at a time, and it has to be unmapped
+    // before GL reads from the buffer. Throws std::invalid_argument unless
+    // `alignment` is a power of two
+    Region Map(GLsizeiptr size, GLsizeiptr alignment = 16);
+    void Unmap();
+    // Copies `data` into a new region and returns its offset
+    GLintptr Write(const void *data, GLsizeiptr size, GLsizeiptr alignment = 16);
+
+    // Call after the last draw reading regions of this frame
+    void EndFrame();
+
+    void Bind() const;
+    void BindRange(GLuint index, GLintptr offset, GLsizeiptr size) const;
+
+    [[nodiscard]] GLuint name() const {
+      return buffer_.get();
+    }
+    [[nodiscard]] GLsizeiptr size() const {
+      return size_;
+    }
+    [[nodiscard]] const Statistics &statistics() const {
+      return statistics_;
+    }
+    void Report(std::ostream &output) const;
+
+  private:
+    struct Frame {
+      GLsync fence;
+      // Offset the frame ended at
+      std::size_t end;
+    };
+
+    GLenum target_;
+    Buffer buffer_;
+    GLsizeiptr size_;
+    // Offsets grow forever; the position in the buffer is modulo the size
+    std::size_t head_ = 0;
+    // Everything before it is no longer read by the GPU
+    std::size_t tail_ = 0;
+    // Start of the regions not fenced yet
+    std::size_t frame_start_ = 0;
+    std::deque<Frame> frames_;
+    bool mapped_ = false;
+    Statistics statistics_;
+
+    // Retires the frames the GPU is done with, waiting for them if `block`
+    void Retire(bool block);
+};
+}
+
+#endif //STREAM_BUFFER_H
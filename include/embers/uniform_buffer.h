@@ -0,0 +1,74 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef UNIFORM_BUFFER_H
+#define UNIFORM_BUFFER_H
+
+#include <cstddef>
+#include <glad/glad.h>
+
+#include <embers/gl_handle.h>
+#include <embers/shader.h>
+#include <embers/std140.h>
+#include <embers/stream_buffer.h>
+
+namespace embers::gl {
+namespace detail {
+Buffer CreateUniformBuffer(std::size_t size);
+void UploadUniformBuffer(GLuint buffer, GLuint binding, const void *data, std::size_t size);
+// Binds `range` bytes, as the block may be read past the end of `size`
+void StreamUniformBuffer(StreamBuffer &stream, GLuint binding, const void *data, std::size_t size, std::size_t range);
+}
+
+// Uniforms shared by every program with a block mirrored by T, e.g. camera
+// or time. They are written to the CPU copy, then uploaded once per frame in
+// a single write, instead of set one by one on each program
+template<typename T>
+class UniformBuffer {
+    static_assert(std140::kMatches<T>, "T is not laid out like a std140 block");
+
+  public:
+    explicit UniformBuffer(const GLuint binding, const T &data = {})
+      : binding_(binding)
+    , buffer_(detail::CreateUniformBuffer(std140::kBufferSize<T>))
+    , data_(data) {}
+    UniformBuffer(const UniformBuffer &) = delete;
+    UniformBuffer &operator=(const UniformBuffer &) = delete;
+
+    // Binds the block `name` of `program` to this buffer. Throws
+    // ShaderException if the program has no such block or it does not fit
+    UniformBuffer &Attach(shader::Program &program, const shader::UniformName name) {
+      program.BindUniformBlock(name, binding_, std140::kBufferSize<T>);
+      return *this;
+    }
+
+    T &data() {
+      return data_;
+    }
+    [[nodiscard]] const T &data() const {
+      return data_;
+    }
+
+    // Replaces the contents of the buffer and binds it
+    void Upload() const {
+      detail::UploadUniformBuffer(buffer_.get(), binding_, &data_, sizeof(T));
+    }
+    // Writes the data to a fresh region of `stream` and binds that instead,
+    // which never waits for draws still reading the previous upload
+    void Upload(StreamBuffer &stream) const {
+      detail::StreamUniformBuffer(stream, binding_, &data_, sizeof(T), std140::kBufferSize<T>);
+    }
+
+    [[nodiscard]] GLuint binding() const {
+      return binding_;
+    }
+
+  private:
+    GLuint binding_;
+    Buffer buffer_;
+    T data_;
+};
+}
+
+#endif //UNIFORM_BUFFER_H
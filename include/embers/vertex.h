@@ -0,0 +1,269 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#ifndef VERTEX_H
+#define VERTEX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <glad/glad.h>
+
+#include <embers/gl_state.h>
+#include <embers/reflect.h>
+
+// Vertex formats described by plain structs. Each field is one attribute, in
+// locations counted up from the one passed to SetAttributes:
+//
+//   struct Vertex {
+//     vertex::Vec<GLfloat, 2> position;
+//     vertex::Vec<GLubyte, 4, true> color;
+//   };
+//   vertex::SetAttributes<Vertex>(0, buffer);
+namespace embers::vertex {
+// 16-bit float, converted with round to nearest even
+struct Half {
+  std::uint16_t bits = 0;
+
+  Half() = default;
+  Half(float value);
+};
+
+// N components of T. Integer components are read as floats by the shader,
+// scaled to [0, 1] or [-1, 1] if `normalized`
+template<typename T, int N, bool normalized = false>
+struct Vec {
+  static_assert(N >= 1 && N <= 4, "attributes have 1 to 4 components");
+  T value[N];
+};
+
+// N integer components read as integers by the shader, e.g. an ivec2
+template<typename T, int N>
+struct IVec {
+  static_assert(std::is_integral_v<T>, "IVec components are integers");
+  static_assert(N >= 1 && N <= 4, "attributes have 1 to 4 components");
+  T value[N];
+};
+
+// Four components in 32 bits: 10 each for x, y and z, 2 for w. Good for
+// normals and tangents
+template<bool is_signed = true, bool normalized = true>
+struct Packed2101010 {
+  std::uint32_t bits = 0;
+
+  Packed2101010() = default;
+  // Expects [-1, 1] or [0, 1] when normalized, integers otherwise
+  Packed2101010(const float x, const float y, const float z, const float w = 0)
+    : bits(Pack(x, 10, 0) | Pack(y, 10, 10) | Pack(z, 10, 20) | Pack(w, 2, 30)) {}
+
+  private:
+    static std::uint32_t Pack(float value, const int width, const int shift) {
+      if constexpr (normalized) {
+        const float limit = is_signed ? 1.f : 0.f;
+        value = value < -limit ? -limit : value > 1.f ? 1.f : value;
+        value *= static_cast<float>((1 << (width - is_signed)) - 1);
+      }
+      const auto integer = static_cast<std::int32_t>(value < 0 ? value - .5f : value + .5f);
+      return (static_cast<std::uint32_t>(integer) & ((1u << width) - 1)) << shift;
+    }
+};
+
+// How GL reads a field of a vertex
+struct Attribute {
+  GLint size;
+  GLenum type;
+  GLboolean normalized;
+  // Read with glVertexAttribIPointer
+  bool integer;
+  GLuint offset;
+  GLuint bytes;
+};
+
+namespace detail {
+template<typename T>
+constexpr GLenum ComponentType() {
+  if constexpr (std::is_same_v<T, GLfloat>) {
+    return GL_FLOAT;
+  } else if constexpr (std::is_same_v<T, Half>) {
+    return GL_HALF_FLOAT;
+  } else if constexpr (std::is_same_v<T, GLbyte>) {
+    return GL_BYTE;
+  } else if constexpr (std::is_same_v<T, GLubyte>) {
+    return GL_UNSIGNED_BYTE;
+  } else if constexpr (std::is_same_v<T, GLshort>) {
+    return GL_SHORT;
+  } else if constexpr (std::is_same_v<T, GLushort>) {
+    return GL_UNSIGNED_SHORT;
+  } else if constexpr (std::is_same_v<T, GLint>) {
+    return GL_INT;
+  } else if constexpr (std::is_same_v<T, GLuint>) {
+    return GL_UNSIGNED_INT;
+  } else {
+    static_assert(sizeof(T) == 0, "unsupported attribute component type");
+  }
+}
+
+template<typename Field>
+struct Format {
+  static constexpr GLint kSize = 1;
+  static constexpr GLenum kType = ComponentType<Field>();
+  static constexpr bool kNormalized = false;
+  static constexpr bool kInteger = false;
+};
+
+template<typename T, int N, bool normalized>
+struct Format<Vec<T, N, normalized>> {
+  static constexpr GLint kSize = N;
+  static constexpr GLenum kType = ComponentType<T>();
+  static constexpr bool kNormalized = normalized;
+  static constexpr bool kInteger = false;
+};
+
+template<typename T, int N>
+struct Format<IVec<T, N>> {
+  static constexpr GLint kSize = N;
+  static constexpr GLenum kType = ComponentType<T>();
+  static constexpr bool kNormalized = false;
+  static constexpr bool kInteger = true;
+};
+
+template<bool is_signed, bool normalized>
+struct Format<Packed2101010<is_signed, normalized>> {
+  static constexpr GLint kSize = 4;
+  static constexpr GLenum kType = is_signed ? GL_INT_2_10_10_10_REV : GL_UNSIGNED_INT_2_10_10_10_REV;
+  static constexpr bool kNormalized = normalized;
+  static constexpr bool kInteger = false;
+};
+
+constexpr std::size_t AlignUp(const std::size_t offset, const std::size_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+// Offsets follow from the usual layout rules of standard-layout structs,
+// checked against the actual size below
+template<typename T, std::size_t... I>
+constexpr std::array<Attribute, sizeof...(I)> Attributes(std::index_sequence<I...>) {
+  std::array<Attribute, sizeof...(I)> attributes{};
+  std::size_t offset = 0;
+  (
+    [&] {
+      using Field = reflect::FieldType<T, I>;
+      offset = AlignUp(offset, alignof(Field));
+      attributes[I] = {
+        Format<Field>::kSize,
+        Format<Field>::kType,
+        Format<Field>::kNormalized ? GLboolean(GL_TRUE) : GLboolean(GL_FALSE),
+        Format<Field>::kInteger,
+        static_cast<GLuint>(offset),
+        static_cast<GLuint>(sizeof(Field))
+      };
+      offset += sizeof(Field);
+    }(),
+    ...
+  );
+  return attributes;
+}
+
+template<typename T>
+constexpr std::size_t PackedSize() {
+  const auto &last = Attributes<T>(std::make_index_sequence<reflect::kFieldCount<T>>()).back();
+  return AlignUp(last.offset + last.bytes, alignof(T));
+}
+}
+
+// Attribute formats, offsets and stride of T, all known at compile time
+template<typename T>
+struct Layout {
+  static_assert(std::is_standard_layout_v<T> && std::is_trivially_copyable_v<T>, "vertices are plain structs");
+
+  static constexpr std::size_t kCount = reflect::kFieldCount<T>;
+  static constexpr std::array<Attribute, kCount> kAttributes =
+    detail::Attributes<T>(std::make_index_sequence<kCount>());
+  static constexpr GLsizei kStride = sizeof(T);
+
+  static_assert(detail::PackedSize<T>() == sizeof(T), "vertex has padding or fields that are not attributes");
+};
+
+enum class Storage {
+  // Whole vertices one after the other
+  kInterleaved,
+  // All values of the first field, then all of the second, and so on, each
+  // array starting on a 4-byte boundary
+  kSeparate,
+};
+
+// Bytes taken by `count` vertices stored as `storage`
+template<typename T>
+constexpr std::size_t SizeOf(const Storage storage, const std::size_t count) {
+  if (storage == Storage::kInterleaved) {
+    return count * sizeof(T);
+  }
+  std::size_t size = 0;
+  for (const Attribute &attribute : Layout<T>::kAttributes) {
+    size = detail::AlignUp(size, 4) + count * attribute.bytes;
+  }
+  return size;
+}
+
+// Writes `vertices` to `destination`, which has room for SizeOf them
+template<typename T>
+void Store(const std::span<const T> vertices, const Storage storage, void *destination) {
+  auto *bytes = static_cast<std::byte *>(destination);
+  if (storage == Storage::kInterleaved) {
+    std::memcpy(bytes, vertices.data(), vertices.size_bytes());
+    return;
+  }
+  [&]<std::size_t... I>(std::index_sequence<I...>) {
+    std::size_t offset = 0;
+    (
+      [&] {
+        offset = detail::AlignUp(offset, 4);
+        constexpr std::size_t kBytes = Layout<T>::kAttributes[I].bytes;
+        for (const T &vertex : vertices) {
+          std::memcpy(bytes + offset, &std::get<I>(reflect::Tie(vertex)), kBytes);
+          offset += kBytes;
+        }
+      }(),
+      ...
+    );
+  }(std::make_index_sequence<Layout<T>::kCount>());
+}
+
+// Points one attribute at `buffer`, which SetAttributes has bound
+void SetAttribute(GLuint location, const Attribute &attribute, GLsizei stride, GLintptr offset, GLuint divisor);
+
+// Points the attributes of the bound vertex array at `count` vertices of T
+// in `buffer`, starting `offset` bytes in. `count` only matters for separate
+// storage. A `divisor` above 0 advances the attributes once per that many
+// instances rather than once per vertex
+template<typename T>
+void SetAttributes(
+  const GLuint first_location,
+  const GLuint buffer,
+  const Storage storage = Storage::kInterleaved,
+  const std::size_t count = 0,
+  const GLintptr offset = 0,
+  const GLuint divisor = 0
+) {
+  gl::State::Current().BindBuffer(GL_ARRAY_BUFFER, buffer);
+  std::size_t separate_offset = 0;
+  for (std::size_t i = 0; i < Layout<T>::kCount; ++i) {
+    const Attribute &attribute = Layout<T>::kAttributes[i];
+    if (storage == Storage::kInterleaved) {
+      SetAttribute(first_location + i, attribute, Layout<T>::kStride, offset + attribute.offset, divisor);
+    } else {
+      separate_offset = detail::AlignUp(separate_offset, 4);
+      SetAttribute(first_location + i, attribute, 0, offset + separate_offset, divisor);
+      separate_offset += count * attribute.bytes;
+    }
+  }
+}
+}
+
+#endif //VERTEX_H
@@ -0,0 +1,358 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/asset.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+#include "embers/mapped_file.h"
+
+namespace embers::asset {
+namespace {
+bool IsSpace(const char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Header fields of a PNM file, which are separated by whitespace and may be
+// interleaved with comments
+int ReadPnmField(const std::string_view data, std::size_t &at) {
+  while (at < data.size() && (IsSpace(data[at]) || data[at] == '#')) {
+    if (data[at] == '#') {
+      while (at < data.size() && data[at] != '\n') {
+        ++at;
+      }
+    } else {
+      ++at;
+    }
+  }
+  int value = 0;
+  const auto [end, error] = std::from_chars(data.data() + at, data.data() + data.size(), value);
+  if (error != std::errc() || value <= 0) {
+    throw AssetException("PNM: bad header");
+  }
+  at = end - data.data();
+  return value;
+}
+
+std::uint16_t ReadLittle16(const std::string_view data, const std::size_t at) {
+  return static_cast<std::uint16_t>(
+    static_cast<std::uint8_t>(data[at]) | static_cast<std::uint8_t>(data[at + 1]) << 8
+  );
+}
+
+// Vertices are merged by the indices of their attributes, 0 where absent
+struct ObjKey {
+  std::uint32_t position;
+  std::uint32_t uv;
+  std::uint32_t normal;
+
+  bool operator==(const ObjKey &) const = default;
+};
+
+struct ObjKeyHash {
+  std::size_t operator()(const ObjKey &key) const {
+    std::size_t hash = key.position;
+    hash = hash * 0x9E3779B97F4A7C15ull ^ key.uv;
+    hash = hash * 0x9E3779B97F4A7C15ull ^ key.normal;
+    return hash;
+  }
+};
+
+class ObjParser {
+  public:
+    explicit ObjParser(const std::string_view text) : text_(text) {}
+
+    Mesh Parse() {
+      while (at_ < text_.size()) {
+        ++line_;
+        const std::size_t end = std::min(text_.find('\n', at_), text_.size());
+        line_end_ = end;
+        ParseLine();
+        at_ = end + 1;
+      }
+      return std::move(mesh_);
+    }
+
+  private:
+    std::string_view text_;
+    std::size_t at_ = 0;
+    std::size_t line_end_ = 0;
+    std::size_t line_ = 0;
+    std::vector<vertex::Vec<GLfloat, 3>> positions_;
+    std::vector<vertex::Vec<GLfloat, 2>> uvs_;
+    std::vector<vertex::Vec<GLfloat, 3>> normals_;
+    std::unordered_map<ObjKey, std::uint32_t, ObjKeyHash> vertices_;
+    std::vector<std::uint32_t> polygon_;
+    Mesh mesh_;
+
+    [[noreturn]] void Fail(const char *what) const {
+      throw AssetException("OBJ: " + std::string(what) + " on line " + std::to_string(line_));
+    }
+
+    void SkipSpace() {
+      while (at_ < line_end_ && (text_[at_] == ' ' || text_[at_] == '\t' || text_[at_] == '\r')) {
+        ++at_;
+      }
+    }
+
+    std::string_view Word() {
+      SkipSpace();
+      const std::size_t start = at_;
+      while (at_ < line_end_ && !IsSpace(text_[at_])) {
+        ++at_;
+      }
+      return text_.substr(start, at_ - start);
+    }
+
+    template<int N>
+    vertex::Vec<GLfloat, N> Floats() {
+      vertex::Vec<GLfloat, N> vec{};
+      for (GLfloat &value : vec.value) {
+        SkipSpace();
+        const auto [end, error] = std::from_chars(text_.data() + at_, text_.data() + line_end_, value);
+        if (error != std::errc()) {
+          Fail("bad number");
+        }
+        at_ = end - text_.data();
+      }
+      return vec;
+    }
+
+    // Resolves a 1-based or negative, relative index into `count` items
+    std::uint32_t Index(const std::string_view word, const std::size_t count) {
+      long index = 0;
+      const auto [end, error] = std::from_chars(word.data(), word.data() + word.size(), index);
+      if (error != std::errc() || end != word.data() + word.size()) {
+        Fail("bad index");
+      }
+      if (index < 0) {
+        index += static_cast<long>(count) + 1;
+      }
+      if (index <= 0 || static_cast<std::size_t>(index) > count) {
+        Fail("index out of range");
+      }
+      return static_cast<std::uint32_t>(index);
+    }
+
+    std::uint32_t Corner(const std::string_view word) {
+      ObjKey key{};
+      const std::size_t first_slash = word.find('/');
+      key.position = Index(word.substr(0, first_slash), positions_.size());
+      if (first_slash != std::string_view::npos) {
+        const std::string_view rest = word.substr(first_slash + 1);
+        const std::size_t second_slash = rest.find('/');
+        if (const std::string_view uv = rest.substr(0, second_slash); !uv.empty()) {
+          key.uv = Index(uv, uvs_.size());
+        }
+        if (second_slash != std::string_view::npos) {
+          key.normal = Index(rest.substr(second_slash + 1), normals_.size());
+        }
+      }
+
+      const auto [found, inserted] = vertices_.try_emplace(key, static_cast<std::uint32_t>(mesh_.vertices.size()));
+      if (inserted) {
+        MeshVertex &vertex = mesh_.vertices.emplace_back();
+        vertex.position = positions_[key.position - 1];
+        if (key.uv) {
+          vertex.uv = uvs_[key.uv - 1];
+        }
+        if (key.normal) {
+          vertex.normal = normals_[key.normal - 1];
+        }
+      }
+      return found->second;
+    }
+
+    void ParseLine() {
+      const std::string_view keyword = Word();
+      if (keyword == "v") {
+        positions_.push_back(Floats<3>());
+      } else if (keyword == "vt") {
+        uvs_.push_back(Floats<2>());
+      } else if (keyword == "vn") {
+        normals_.push_back(Floats<3>());
+      } else if (keyword == "f") {
+        polygon_.clear();
+        for (std::string_view word = Word(); !word.empty(); word = Word()) {
+          polygon_.push_back(Corner(word));
+        }
+        if (polygon_.size() < 3) {
+          Fail("face with fewer than 3 corners");
+        }
+        for (std::size_t i = 2; i < polygon_.size(); ++i) {
+          mesh_.indices.insert(mesh_.indices.end(), {polygon_[0], polygon_[i - 1], polygon_[i]});
+        }
+      }
+      // Comments, groups, materials and the rest do not affect geometry
+    }
+};
+
+std::string Extension(const std::filesystem::path &path) {
+  std::string extension = path.extension().string();
+  std::ranges::transform(extension, extension.begin(), [](const unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  return extension;
+}
+}
+
+Image DecodePnm(const std::string_view data) {
+  if (data.size() < 2 || data[0] != 'P' || (data[1] != '5' && data[1] != '6')) {
+    throw AssetException("PNM: not a binary PGM or PPM");
+  }
+  std::size_t at = 2;
+  Image image;
+  image.channels = data[1] == '6' ? 3 : 1;
+  image.width = ReadPnmField(data, at);
+  image.height = ReadPnmField(data, at);
+  const int max_value = ReadPnmField(data, at);
+  if (max_value > 255) {
+    throw AssetException("PNM: only 8 bits per channel are supported");
+  }
+  // A single whitespace character separates the header from the pixels
+  ++at;
+
+  const std::size_t row = static_cast<std::size_t>(image.width) * image.channels;
+  if (data.size() < at || (data.size() - at) / row < static_cast<std::size_t>(image.height)) {
+    throw AssetException("PNM: truncated");
+  }
+  image.pixels.resize(row * image.height);
+  // Rows are stored top first
+  for (int y = 0; y < image.height; ++y) {
+    std::memcpy(image.pixels.data() + (image.height - 1 - y) * row, data.data() + at + y * row, row);
+  }
+  if (max_value != 255) {
+    for (std::uint8_t &value : image.pixels) {
+      value = static_cast<std::uint8_t>(std::min(value, static_cast<std::uint8_t>(max_value)) * 255 / max_value);
+    }
+  }
+  return image;
+}
+
+Image DecodeTga(const std::string_view data) {
+  constexpr std::size_t kHeaderSize = 18;
+  if (data.size() < kHeaderSize) {
+    throw AssetException("TGA: truncated");
+  }
+  const auto byte = [data](const std::size_t at) { return static_cast<std::uint8_t>(data[at]); };
+  const int type = byte(2);
+  const bool run_length = type == 10 || type == 11;
+  const bool grey = type == 3 || type == 11;
+  if (type != 2 && type != 3 && type != 10 && type != 11) {
+    throw AssetException("TGA: only true colour and greyscale images are supported");
+  }
+  const int bits = byte(16);
+  if (grey ? bits != 8 : bits != 24 && bits != 32) {
+    throw AssetException("TGA: unsupported pixel depth");
+  }
+
+  Image image;
+  image.width = ReadLittle16(data, 12);
+  image.height = ReadLittle16(data, 14);
+  image.channels = bits / 8;
+  if (image.width == 0 || image.height == 0) {
+    throw AssetException("TGA: empty image");
+  }
+  const bool right_to_left = byte(17) & 0x10;
+  const bool top_to_bottom = byte(17) & 0x20;
+  // The image ID and an unused colour map come before the pixels
+  std::size_t at = kHeaderSize + byte(0);
+  if (byte(1)) {
+    at += ReadLittle16(data, 5) * ((byte(7) + 7) / 8);
+  }
+
+  const std::size_t pixel = image.channels;
+  const std::size_t count = static_cast<std::size_t>(image.width) * image.height;
+  std::vector<std::uint8_t> stored(count * pixel);
+  if (!run_length) {
+    if (data.size() < at || data.size() - at < stored.size()) {
+      throw AssetException("TGA: truncated");
+    }
+    std::memcpy(stored.data(), data.data() + at, stored.size());
+  } else {
+    // Packets of up to 128 pixels, either one repeated or stored as is
+    for (std::size_t done = 0; done < count;) {
+      if (at >= data.size()) {
+        throw AssetException("TGA: truncated");
+      }
+      const std::uint8_t packet = byte(at++);
+      const std::size_t length = std::min<std::size_t>((packet & 0x7F) + 1, count - done);
+      const std::size_t bytes = packet & 0x80 ? pixel : length * pixel;
+      if (data.size() - at < bytes) {
+        throw AssetException("TGA: truncated");
+      }
+      if (packet & 0x80) {
+        for (std::size_t i = 0; i < length; ++i) {
+          std::memcpy(stored.data() + (done + i) * pixel, data.data() + at, pixel);
+        }
+      } else {
+        std::memcpy(stored.data() + done * pixel, data.data() + at, bytes);
+      }
+      at += bytes;
+      done += length;
+    }
+  }
+
+  // Pixels are BGR or BGRA, from the corner the descriptor names
+  image.pixels.resize(stored.size());
+  const std::uint8_t *from = stored.data();
+  for (int row = 0; row < image.height; ++row) {
+    const int y = top_to_bottom ? image.height - 1 - row : row;
+    for (int column = 0; column < image.width; ++column, from += pixel) {
+      const int x = right_to_left ? image.width - 1 - column : column;
+      std::uint8_t *to = image.pixels.data() + (static_cast<std::size_t>(y) * image.width + x) * pixel;
+      if (grey) {
+        to[0] = from[0];
+      } else {
+        to[0] = from[2];
+        to[1] = from[1];
+        to[2] = from[0];
+        if (pixel == 4) {
+          to[3] = from[3];
+        }
+      }
+    }
+  }
+  return image;
+}
+
+Mesh DecodeObj(const std::string_view text) {
+  return ObjParser(text).Parse();
+}
+
+Image LoadImage(const std::filesystem::path &path) {
+  const std::string extension = Extension(path);
+  Image (*decode)(std::string_view) = nullptr;
+  if (extension == ".ppm" || extension == ".pgm" || extension == ".pnm") {
+    decode = DecodePnm;
+  } else if (extension == ".tga") {
+    decode = DecodeTga;
+  } else {
+    throw AssetException(path.string() + ": unknown image format");
+  }
+  const MappedFile file(path);
+  try {
+    return decode(file.view());
+  } catch (const AssetException &exception) {
+    throw AssetException(path.string() + ": " + exception.what());
+  }
+}
+
+Mesh LoadMesh(const std::filesystem::path &path) {
+  if (Extension(path) != ".obj") {
+    throw AssetException(path.string() + ": unknown mesh format");
+  }
+  const MappedFile file(path);
+  try {
+    return DecodeObj(file.view());
+  } catch (const AssetException &exception) {
+    throw AssetException(path.string() + ": " + exception.what());
+  }
+}
+}
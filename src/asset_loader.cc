@@ -0,0 +1,298 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/asset_loader.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "embers/gl_state.h"
+#include "embers/vertex.h"
+
+namespace embers::asset {
+namespace {
+// Smallest mesh copy a Pump makes when its budget is used up
+constexpr GLsizeiptr kMinMeshChunk = 64 << 10;
+
+GLenum TextureFormat(const int channels) {
+  switch (channels) {
+    case 1: return GL_RED;
+    case 3: return GL_RGB;
+    default: return GL_RGBA;
+  }
+}
+
+GLint TextureInternalFormat(const int channels) {
+  switch (channels) {
+    case 1: return GL_R8;
+    case 3: return GL_RGB8;
+    default: return GL_RGBA8;
+  }
+}
+}
+
+struct Loader::Job {
+  std::filesystem::path path;
+  // One of them is set
+  std::shared_ptr<detail::Slot<Texture>> texture_slot;
+  std::shared_ptr<detail::Slot<GpuMesh>> mesh_slot;
+  // Filled in by the decode task
+  Image image;
+  Mesh mesh;
+  std::exception_ptr error;
+  // Rows of a texture or bytes of a mesh, vertices first, uploaded so far
+  std::size_t uploaded = 0;
+  Texture texture;
+  GpuMesh gpu_mesh;
+};
+
+Loader::Loader(JobSystem &jobs, const GLsizeiptr staging_size)
+  : jobs_(jobs)
+, staging_(GL_PIXEL_UNPACK_BUFFER, staging_size)
+, max_chunk_(std::max<GLsizeiptr>(staging_size / 4, 1))
+, inbox_(std::make_shared<Inbox>()) {}
+
+Future<Texture> Loader::LoadTexture(const std::filesystem::path &path) {
+  auto job = std::make_shared<Job>();
+  job->path = path;
+  job->texture_slot = std::make_shared<detail::Slot<Texture>>();
+  Future<Texture> future(job->texture_slot);
+  Decode(std::move(job));
+  return future;
+}
+
+Future<GpuMesh> Loader::LoadMesh(const std::filesystem::path &path) {
+  auto job = std::make_shared<Job>();
+  job->path = path;
+  job->mesh_slot = std::make_shared<detail::Slot<GpuMesh>>();
+  Future<GpuMesh> future(job->mesh_slot);
+  Decode(std::move(job));
+  return future;
+}
+
+void Loader::Decode(std::shared_ptr<Job> job) {
+  {
+    std::lock_guard lock(inbox_->mutex);
+    ++inbox_->decoding;
+  }
+  jobs_.Spawn([inbox = inbox_, job = std::move(job)] {
+    try {
+      if (job->texture_slot) {
+        job->image = asset::LoadImage(job->path);
+      } else {
+        job->mesh = asset::LoadMesh(job->path);
+      }
+    } catch (...) {
+      job->error = std::current_exception();
+    }
+    std::lock_guard lock(inbox->mutex);
+    inbox->jobs.push_back(job);
+    --inbox->decoding;
+    inbox->decoded.notify_all();
+  });
+}
+
+void Loader::Pump(const GLsizeiptr byte_budget) {
+  {
+    std::lock_guard lock(inbox_->mutex);
+    uploads_.insert(uploads_.end(), inbox_->jobs.begin(), inbox_->jobs.end());
+    inbox_->jobs.clear();
+  }
+
+  GLsizeiptr budget = byte_budget;
+  bool progressed = false;
+  bool uploaded = false;
+  bool textures = false;
+  while (!uploads_.empty()) {
+    Job &job = *uploads_.front();
+    if (job.error) {
+      Fail(job, job.error);
+      uploads_.pop_front();
+      continue;
+    }
+    uploaded = true;
+    bool done;
+    try {
+      if (job.texture_slot) {
+        textures = true;
+        done = UploadTexture(job, budget, progressed);
+      } else {
+        done = UploadMesh(job, budget, progressed);
+      }
+    } catch (...) {
+      Fail(job, std::current_exception());
+      uploads_.pop_front();
+      continue;
+    }
+    if (!done) {
+      break;
+    }
+    Complete(job);
+    uploads_.pop_front();
+  }
+
+  if (uploaded) {
+    gl::State &state = gl::State::Current();
+    state.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    state.BindVertexArray(0);
+    staging_.EndFrame();
+  }
+  if (textures) {
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+  }
+}
+
+void Loader::Finish() {
+  {
+    std::unique_lock lock(inbox_->mutex);
+    inbox_->decoded.wait(lock, [this] { return inbox_->decoding == 0; });
+  }
+  while (pending()) {
+    Pump(std::numeric_limits<GLsizeiptr>::max());
+  }
+}
+
+std::size_t Loader::pending() const {
+  std::lock_guard lock(inbox_->mutex);
+  return inbox_->decoding + inbox_->jobs.size() + uploads_.size();
+}
+
+bool Loader::UploadTexture(Job &job, GLsizeiptr &budget, bool &progressed) {
+  const Image &image = job.image;
+  const GLenum format = TextureFormat(image.channels);
+  const auto row = static_cast<GLsizeiptr>(image.width) * image.channels;
+  if (!job.texture.texture) {
+    if (row > max_chunk_) {
+      throw std::length_error(job.path.string() + ": texture rows do not fit in the staging buffer");
+    }
+    job.texture = {gl::Texture::Create(), image.width, image.height};
+    glBindTexture(GL_TEXTURE_2D, job.texture.texture.get());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    // Storage only, the pixels come from the staging buffer
+    gl::State::Current().BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glTexImage2D(
+      GL_TEXTURE_2D,
+      0,
+      TextureInternalFormat(image.channels),
+      image.width,
+      image.height,
+      0,
+      format,
+      GL_UNSIGNED_BYTE,
+      nullptr
+    );
+  } else {
+    glBindTexture(GL_TEXTURE_2D, job.texture.texture.get());
+  }
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  while (job.uploaded < static_cast<std::size_t>(image.height)) {
+    auto rows = std::min<GLsizeiptr>(std::min(budget, max_chunk_) / row, image.height - job.uploaded);
+    if (rows == 0) {
+      if (progressed) {
+        return false;
+      }
+      rows = 1;
+    }
+    const GLintptr offset = Stage(image.pixels.data() + job.uploaded * row, rows * row);
+    staging_.Bind();
+    glTexSubImage2D(
+      GL_TEXTURE_2D,
+      0,
+      0,
+      static_cast<GLint>(job.uploaded),
+      image.width,
+      static_cast<GLsizei>(rows),
+      format,
+      GL_UNSIGNED_BYTE,
+      reinterpret_cast<const void *>(offset)
+    );
+    job.uploaded += rows;
+    budget = std::max<GLsizeiptr>(budget - rows * row, 0);
+    progressed = true;
+  }
+  return true;
+}
+
+bool Loader::UploadMesh(Job &job, GLsizeiptr &budget, bool &progressed) {
+  const Mesh &mesh = job.mesh;
+  const auto vertex_bytes = static_cast<GLsizeiptr>(mesh.vertices.size() * sizeof(MeshVertex));
+  const auto index_bytes = static_cast<GLsizeiptr>(mesh.indices.size() * sizeof(std::uint32_t));
+  gl::State &state = gl::State::Current();
+  if (!job.gpu_mesh.vertex_buffer) {
+    job.gpu_mesh.vertex_buffer = gl::Buffer::Create();
+    job.gpu_mesh.index_buffer = gl::Buffer::Create();
+    job.gpu_mesh.index_count = static_cast<GLsizei>(mesh.indices.size());
+    // Through the copy target, so the element array binding of the current
+    // vertex array is left alone
+    state.BindBuffer(GL_COPY_WRITE_BUFFER, job.gpu_mesh.vertex_buffer.get());
+    glBufferData(GL_COPY_WRITE_BUFFER, vertex_bytes, nullptr, GL_STATIC_DRAW);
+    state.BindBuffer(GL_COPY_WRITE_BUFFER, job.gpu_mesh.index_buffer.get());
+    glBufferData(GL_COPY_WRITE_BUFFER, index_bytes, nullptr, GL_STATIC_DRAW);
+  }
+
+  const auto total = static_cast<std::size_t>(vertex_bytes + index_bytes);
+  while (job.uploaded < total) {
+    const bool vertices = job.uploaded < static_cast<std::size_t>(vertex_bytes);
+    const std::size_t start = vertices ? job.uploaded : job.uploaded - vertex_bytes;
+    const std::size_t end = vertices ? vertex_bytes : index_bytes;
+    const auto *data = vertices
+      ? reinterpret_cast<const std::byte *>(mesh.vertices.data())
+      : reinterpret_cast<const std::byte *>(mesh.indices.data());
+    const GLuint buffer = vertices ? job.gpu_mesh.vertex_buffer.get() : job.gpu_mesh.index_buffer.get();
+
+    auto size = std::min<GLsizeiptr>(std::min(budget, max_chunk_), end - start);
+    if (size == 0) {
+      if (progressed) {
+        return false;
+      }
+      size = std::min<GLsizeiptr>(std::min(kMinMeshChunk, max_chunk_), end - start);
+    }
+    const GLintptr offset = Stage(data + start, size);
+    state.BindBuffer(GL_COPY_READ_BUFFER, staging_.name());
+    state.BindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, offset, static_cast<GLintptr>(start), size);
+    job.uploaded += size;
+    budget = std::max<GLsizeiptr>(budget - size, 0);
+    progressed = true;
+  }
+
+  job.gpu_mesh.vertex_array = gl::VertexArray::Create();
+  state.BindVertexArray(job.gpu_mesh.vertex_array.get());
+  vertex::SetAttributes<MeshVertex>(0, job.gpu_mesh.vertex_buffer.get());
+  state.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, job.gpu_mesh.index_buffer.get());
+  return true;
+}
+
+GLintptr Loader::Stage(const void *data, const GLsizeiptr size) {
+  statistics_.bytes += size;
+  return staging_.Write(data, size, 4);
+}
+
+void Loader::Complete(Job &job) {
+  if (job.texture_slot) {
+    job.texture_slot->value = std::move(job.texture);
+    job.texture_slot->done = true;
+    ++statistics_.textures;
+  } else {
+    job.mesh_slot->value = std::move(job.gpu_mesh);
+    job.mesh_slot->done = true;
+    ++statistics_.meshes;
+  }
+}
+
+void Loader::Fail(Job &job, const std::exception_ptr error) {
+  if (job.texture_slot) {
+    job.texture_slot->error = error;
+    job.texture_slot->done = true;
+  } else {
+    job.mesh_slot->error = error;
+    job.mesh_slot->done = true;
+  }
+  ++statistics_.failed;
+}
+}
@@ -0,0 +1,290 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/command_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "embers/gl_state.h"
+
+namespace embers::render {
+enum class CommandBuffer::Opcode : std::uint8_t {
+  kUseProgram,
+  kSetBoolean,
+  kSetInt,
+  kSetFloat,
+  kBindVertexArray,
+  kBindBuffer,
+  kBindBufferRange,
+  kEnable,
+  kDisable,
+  kDrawArrays,
+  kDrawElements,
+  kDrawArraysInstanced,
+  kDrawElementsInstanced,
+};
+
+namespace {
+// Every command fits in a block this big
+constexpr std::size_t kMinBlockSize = 256;
+
+template<typename T>
+struct SetUniformCommand {
+  shader::Uniform<T> uniform;
+  T value;
+};
+
+struct BindBufferCommand {
+  GLenum target;
+  GLuint buffer;
+};
+
+struct BindBufferRangeCommand {
+  GLenum target;
+  GLuint index;
+  GLuint buffer;
+  GLintptr offset;
+  GLsizeiptr size;
+};
+
+struct DrawArraysCommand {
+  GLenum mode;
+  GLint first;
+  GLsizei count;
+};
+
+struct DrawElementsCommand {
+  GLenum mode;
+  GLsizei count;
+  GLenum type;
+  std::size_t offset;
+};
+
+struct DrawArraysInstancedCommand {
+  GLenum mode;
+  GLint first;
+  GLsizei count;
+  GLsizei instances;
+};
+
+struct DrawElementsInstancedCommand {
+  GLenum mode;
+  GLsizei count;
+  GLenum type;
+  GLsizei instances;
+  std::size_t offset;
+};
+
+// Arguments are packed without padding, so they are copied out
+template<typename Command>
+Command Read(const std::byte *&at) {
+  Command command;
+  std::memcpy(&command, at, sizeof(Command));
+  at += sizeof(Command);
+  return command;
+}
+}
+
+CommandBuffer::CommandBuffer(const std::size_t block_size)
+  : block_size_(std::max(block_size, kMinBlockSize)) {}
+
+std::byte *CommandBuffer::Allocate(const std::size_t size) {
+  if (blocks_.empty() || blocks_[current_].used + size > block_size_) {
+    if (!blocks_.empty()) {
+      ++current_;
+    }
+    if (current_ == blocks_.size()) {
+      blocks_.push_back({std::make_unique_for_overwrite<std::byte[]>(block_size_), 0});
+    }
+  }
+  Block &block = blocks_[current_];
+  std::byte *data = block.data.get() + block.used;
+  block.used += size;
+  return data;
+}
+
+template<typename Command>
+void CommandBuffer::Record(const Opcode opcode, const Command &command) {
+  std::byte *data = Allocate(1 + sizeof(Command));
+  data[0] = static_cast<std::byte>(opcode);
+  std::memcpy(data + 1, &command, sizeof(Command));
+  ++commands_;
+}
+
+void CommandBuffer::UseProgram(shader::Program &program) {
+  Record(Opcode::kUseProgram, &program);
+  has_program_ = true;
+}
+
+void CommandBuffer::SetUniform(const shader::Uniform<GLboolean> uniform, const GLboolean value) {
+  if (!has_program_) {
+    throw std::logic_error("CommandBuffer: SetUniform before UseProgram");
+  }
+  Record(Opcode::kSetBoolean, SetUniformCommand<GLboolean>{uniform, value});
+}
+
+void CommandBuffer::SetUniform(const shader::Uniform<GLint> uniform, const GLint value) {
+  if (!has_program_) {
+    throw std::logic_error("CommandBuffer: SetUniform before UseProgram");
+  }
+  Record(Opcode::kSetInt, SetUniformCommand<GLint>{uniform, value});
+}
+
+void CommandBuffer::SetUniform(const shader::Uniform<GLfloat> uniform, const GLfloat value) {
+  if (!has_program_) {
+    throw std::logic_error("CommandBuffer: SetUniform before UseProgram");
+  }
+  Record(Opcode::kSetFloat, SetUniformCommand<GLfloat>{uniform, value});
+}
+
+void CommandBuffer::BindVertexArray(const GLuint vertex_array) {
+  Record(Opcode::kBindVertexArray, vertex_array);
+}
+
+void CommandBuffer::BindBuffer(const GLenum target, const GLuint buffer) {
+  Record(Opcode::kBindBuffer, BindBufferCommand{target, buffer});
+}
+
+void CommandBuffer::BindBufferRange(
+  const GLenum target,
+  const GLuint index,
+  const GLuint buffer,
+  const GLintptr offset,
+  const GLsizeiptr size
+) {
+  Record(Opcode::kBindBufferRange, BindBufferRangeCommand{target, index, buffer, offset, size});
+}
+
+void CommandBuffer::Enable(const GLenum capability) {
+  Record(Opcode::kEnable, capability);
+}
+
+void CommandBuffer::Disable(const GLenum capability) {
+  Record(Opcode::kDisable, capability);
+}
+
+void CommandBuffer::DrawArrays(const GLenum mode, const GLint first, const GLsizei count) {
+  Record(Opcode::kDrawArrays, DrawArraysCommand{mode, first, count});
+}
+
+void CommandBuffer::DrawElements(const GLenum mode, const GLsizei count, const GLenum type, const std::size_t offset) {
+  Record(Opcode::kDrawElements, DrawElementsCommand{mode, count, type, offset});
+}
+
+void CommandBuffer::DrawArraysInstanced(
+  const GLenum mode,
+  const GLint first,
+  const GLsizei count,
+  const GLsizei instances
+) {
+  Record(Opcode::kDrawArraysInstanced, DrawArraysInstancedCommand{mode, first, count, instances});
+}
+
+void CommandBuffer::DrawElementsInstanced(
+  const GLenum mode,
+  const GLsizei count,
+  const GLenum type,
+  const std::size_t offset,
+  const GLsizei instances
+) {
+  Record(Opcode::kDrawElementsInstanced, DrawElementsInstancedCommand{mode, count, type, instances, offset});
+}
+
+void CommandBuffer::Replay() const {
+  gl::State &state = gl::State::Current();
+  shader::Program *program = nullptr;
+  for (const Block &block : blocks_) {
+    const std::byte *at = block.data.get();
+    const std::byte *end = at + block.used;
+    while (at < end) {
+      const auto opcode = static_cast<Opcode>(*at++);
+      switch (opcode) {
+        case Opcode::kUseProgram:
+          program = Read<shader::Program *>(at);
+          program->use();
+          break;
+        case Opcode::kSetBoolean: {
+          const auto command = Read<SetUniformCommand<GLboolean>>(at);
+          program->setUniform(command.uniform, command.value);
+          break;
+        }
+        case Opcode::kSetInt: {
+          const auto command = Read<SetUniformCommand<GLint>>(at);
+          program->setUniform(command.uniform, command.value);
+          break;
+        }
+        case Opcode::kSetFloat: {
+          const auto command = Read<SetUniformCommand<GLfloat>>(at);
+          program->setUniform(command.uniform, command.value);
+          break;
+        }
+        case Opcode::kBindVertexArray:
+          state.BindVertexArray(Read<GLuint>(at));
+          break;
+        case Opcode::kBindBuffer: {
+          const auto command = Read<BindBufferCommand>(at);
+          state.BindBuffer(command.target, command.buffer);
+          break;
+        }
+        case Opcode::kBindBufferRange: {
+          const auto command = Read<BindBufferRangeCommand>(at);
+          state.BindBufferRange(command.target, command.index, command.buffer, command.offset, command.size);
+          break;
+        }
+        case Opcode::kEnable:
+          state.Enable(Read<GLenum>(at));
+          break;
+        case Opcode::kDisable:
+          state.Disable(Read<GLenum>(at));
+          break;
+        case Opcode::kDrawArrays: {
+          const auto command = Read<DrawArraysCommand>(at);
+          glDrawArrays(command.mode, command.first, command.count);
+          break;
+        }
+        case Opcode::kDrawElements: {
+          const auto command = Read<DrawElementsCommand>(at);
+          glDrawElements(command.mode, command.count, command.type, reinterpret_cast<const void *>(command.offset));
+          break;
+        }
+        case Opcode::kDrawArraysInstanced: {
+          const auto command = Read<DrawArraysInstancedCommand>(at);
+          glDrawArraysInstanced(command.mode, command.first, command.count, command.instances);
+          break;
+        }
+        case Opcode::kDrawElementsInstanced: {
+          const auto command = Read<DrawElementsInstancedCommand>(at);
+          glDrawElementsInstanced(
+            command.mode,
+            command.count,
+            command.type,
+            reinterpret_cast<const void *>(command.offset),
+            command.instances
+          );
+          break;
+        }
+      }
+    }
+  }
+}
+
+void CommandBuffer::Clear() {
+  for (Block &block : blocks_) {
+    block.used = 0;
+  }
+  current_ = 0;
+  commands_ = 0;
+  has_program_ = false;
+}
+
+std::size_t CommandBuffer::size() const {
+  std::size_t size = 0;
+  for (const Block &block : blocks_) {
+    size += block.used;
+  }
+  return size;
+}
+}
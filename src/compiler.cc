@@ -0,0 +1,331 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/compiler.h"
+
+#include <chrono>
+#include <future>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "embers/gl_handle.h"
+#include "embers/profiler.h"
+#include "embers/program_cache.h"
+
+namespace embers::shader {
+namespace detail {
+// Shared by a future and, in threaded mode, the queued work producing it
+struct CompileJob {
+  bool is_program;
+  // Status already queried, either by the worker or by a cache load
+  bool checked;
+  bool parallel;
+  // Owned until handed out by Get, the one `is_program` says. Given back to
+  // the pools of the thread owning the Compiler, see Compiler::Work
+  gl::Handle<gl::Kind::kShader> shader;
+  gl::Handle<gl::Kind::kProgram> program;
+  std::promise<void> promise;
+  std::shared_future<void> done = promise.get_future().share();
+  // Shaders of a program, kept alive until the program is resolved
+  std::vector<std::shared_ptr<CompileJob>> inputs;
+  // Programs linking this shader; the shader stays alive until they are done
+  std::vector<std::shared_future<void>> dependents;
+  ProgramCache *cache = nullptr;
+  std::uint64_t key = 0;
+  std::chrono::steady_clock::time_point start;
+
+  CompileJob(const bool is_program, const bool checked, const bool parallel)
+    : is_program(is_program)
+  , checked(checked)
+  , parallel(parallel) {}
+};
+}
+
+namespace {
+void ThrowIfNotCompiled(const GLuint shader) {
+  GLint success = GL_FALSE;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+  if (success != GL_FALSE) {
+    return;
+  }
+  GLint log_size = 0;
+  glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &log_size);
+  auto error_log = std::make_unique<char[]>(log_size + 1);
+  glGetShaderInfoLog(shader, log_size + 1, &log_size, error_log.get());
+  throw ShaderException(error_log.get());
+}
+
+void ThrowIfNotLinked(const GLuint program) {
+  GLint success = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  if (success != GL_FALSE) {
+    return;
+  }
+  GLint log_size = 0;
+  glGetProgramiv(program, GL_INFO_LOG_LENGTH, &log_size);
+  auto error_log = std::make_unique<char[]>(log_size + 1);
+  glGetProgramInfoLog(program, log_size + 1, &log_size, error_log.get());
+  throw ShaderException(error_log.get());
+}
+
+void LinkProgram(detail::CompileJob &job, const bool retrievable) {
+  job.program = gl::Handle<gl::Kind::kProgram>::Adopt(glCreateProgram());
+  const GLuint program = job.program.get();
+  if (retrievable) {
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
+  for (const auto &input : job.inputs) {
+    glAttachShader(program, input->shader.get());
+  }
+  glLinkProgram(program);
+  // The linked executable does not need its shaders attached anymore
+  for (const auto &input : job.inputs) {
+    glDetachShader(program, input->shader.get());
+  }
+}
+
+bool IsComplete(const detail::CompileJob &job) {
+  GLint complete = GL_TRUE;
+  if (job.is_program) {
+    glGetProgramiv(job.program.get(), GL_COMPLETION_STATUS_KHR, &complete);
+  } else {
+    glGetShaderiv(job.shader.get(), GL_COMPLETION_STATUS_KHR, &complete);
+  }
+  return complete != GL_FALSE;
+}
+
+bool Ready(const detail::CompileJob &job) {
+  if (job.done.wait_for(std::chrono::seconds::zero()) != std::future_status::ready) {
+    return false;
+  }
+  return job.checked || !job.parallel || IsComplete(job);
+}
+}
+
+// ShaderFuture
+
+ShaderFuture::ShaderFuture(std::shared_ptr<detail::CompileJob> job) : job_(std::move(job)) {}
+
+ShaderFuture::~ShaderFuture() = default;
+
+bool ShaderFuture::Ready() const {
+  return shader::Ready(*job_);
+}
+
+Shader ShaderFuture::Get() {
+  job_->done.get();
+  for (const auto &dependent : job_->dependents) {
+    dependent.wait();
+  }
+  if (!job_->checked) {
+    ThrowIfNotCompiled(job_->shader.get());
+  }
+  return Shader(job_->shader.Release());
+}
+
+// ProgramFuture
+
+ProgramFuture::ProgramFuture(std::shared_ptr<detail::CompileJob> job) : job_(std::move(job)) {}
+
+ProgramFuture::~ProgramFuture() = default;
+
+bool ProgramFuture::Ready() const {
+  return shader::Ready(*job_);
+}
+
+Program ProgramFuture::Get() {
+  job_->done.get();
+  if (!job_->checked) {
+    // A failed shader explains a failed link better than the link log
+    for (const auto &input : job_->inputs) {
+      if (input->shader) {
+        ThrowIfNotCompiled(input->shader.get());
+      }
+    }
+    ThrowIfNotLinked(job_->program.get());
+  }
+  job_->inputs.clear();
+  // Reflection may throw, in which case the job still owns the program
+  Program program(static_cast<GLint>(job_->program.get()));
+  if (job_->cache) {
+    job_->cache->Store(job_->program.get(), job_->key);
+    job_->cache->Record(false, std::chrono::steady_clock::now() - job_->start);
+  }
+  job_->program.Release();
+  return program;
+}
+
+// Compiler
+
+Compiler::Compiler(SharedContext *worker_context)
+  : parallel_(DriverCompilesInParallel())
+, threaded_(!parallel_ && worker_context)
+, worker_context_(worker_context) {
+  if (parallel_) {
+    // Let the driver pick as many threads as it sees fit
+    glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+  }
+  if (threaded_) {
+    worker_ = std::thread(&Compiler::Work, this);
+  }
+}
+
+Compiler::~Compiler() {
+  if (!threaded_) {
+    return;
+  }
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  queue_changed_.notify_one();
+  worker_.join();
+  finished_.clear();
+}
+
+bool Compiler::DriverCompilesInParallel() {
+  return GLAD_GL_KHR_parallel_shader_compile;
+}
+
+ShaderFuture Compiler::Compile(const Source &source) {
+  auto job = std::make_shared<detail::CompileJob>(false, threaded_, parallel_);
+  if (!threaded_) {
+    // Only the submission with parallel compile, the rest is on driver threads
+    profile::CpuZone zone("Compiler::Compile");
+    job->shader = gl::Handle<gl::Kind::kShader>::Adopt(glCreateShader(source.type()));
+    source.Upload(job->shader.get());
+    glCompileShader(job->shader.get());
+    job->promise.set_value();
+    return ShaderFuture(std::move(job));
+  }
+
+  Submit([job, text = source.Join(), type = source.type()] {
+    try {
+      profile::CpuZone zone("Compiler::Compile");
+      job->shader = gl::Handle<gl::Kind::kShader>::Adopt(glCreateShader(type));
+      const char *const sources = text.c_str();
+      glShaderSource(job->shader.get(), 1, &sources, nullptr);
+      glCompileShader(job->shader.get());
+      ThrowIfNotCompiled(job->shader.get());
+      // Objects are only safe to use from the other context once finished
+      glFinish();
+      job->promise.set_value();
+    } catch (...) {
+      job->promise.set_exception(std::current_exception());
+    }
+  });
+  return ShaderFuture(std::move(job));
+}
+
+ProgramFuture Compiler::Link(const std::initializer_list<std::reference_wrapper<const ShaderFuture>> shaders) {
+  std::vector<std::shared_ptr<detail::CompileJob>> inputs;
+  inputs.reserve(shaders.size());
+  for (const ShaderFuture &shader : shaders) {
+    inputs.push_back(shader.job_);
+  }
+  return SubmitLink(std::move(inputs), false);
+}
+
+ProgramFuture Compiler::Build(
+  const std::initializer_list<std::reference_wrapper<const Source>> sources,
+  ProgramCache *cache
+) {
+  const auto start = std::chrono::steady_clock::now();
+  const bool cached = cache && cache->IsSupported();
+  std::uint64_t key = 0;
+  if (cached) {
+    std::vector<const Source *> attached;
+    attached.reserve(sources.size());
+    for (const Source &source : sources) {
+      attached.push_back(&source);
+    }
+    key = cache->Key(attached);
+    auto job = std::make_shared<detail::CompileJob>(true, true, parallel_);
+    job->program = gl::Handle<gl::Kind::kProgram>::Adopt(glCreateProgram());
+    if (cache->Load(job->program.get(), key)) {
+      cache->Record(true, std::chrono::steady_clock::now() - start);
+      job->promise.set_value();
+      return ProgramFuture(std::move(job));
+    }
+    // The rejected program is deleted with its job
+  }
+
+  std::vector<std::shared_ptr<detail::CompileJob>> inputs;
+  inputs.reserve(sources.size());
+  for (const Source &source : sources) {
+    inputs.push_back(Compile(source).job_);
+  }
+  ProgramFuture program = SubmitLink(std::move(inputs), cached);
+  if (cached) {
+    program.job_->cache = cache;
+    program.job_->key = key;
+    program.job_->start = start;
+  }
+  return program;
+}
+
+ProgramFuture Compiler::SubmitLink(std::vector<std::shared_ptr<detail::CompileJob>> inputs, const bool retrievable) {
+  auto job = std::make_shared<detail::CompileJob>(true, threaded_, parallel_);
+  job->inputs = std::move(inputs);
+  for (const auto &input : job->inputs) {
+    input->dependents.push_back(job->done);
+  }
+  if (!threaded_) {
+    profile::CpuZone zone("Compiler::Link");
+    LinkProgram(*job, retrievable);
+    job->promise.set_value();
+    return ProgramFuture(std::move(job));
+  }
+
+  Submit([job, retrievable] {
+    try {
+      // Rethrows the error of a shader that failed to compile
+      for (const auto &input : job->inputs) {
+        input->done.get();
+      }
+      profile::CpuZone zone("Compiler::Link");
+      LinkProgram(*job, retrievable);
+      ThrowIfNotLinked(job->program.get());
+      glFinish();
+      job->promise.set_value();
+    } catch (...) {
+      job->promise.set_exception(std::current_exception());
+    }
+  });
+  return ProgramFuture(std::move(job));
+}
+
+void Compiler::Submit(std::function<void()> job) {
+  std::vector<std::function<void()>> finished;
+  {
+    std::lock_guard lock(mutex_);
+    queue_.push_back(std::move(job));
+    finished.swap(finished_);
+  }
+  queue_changed_.notify_one();
+}
+
+void Compiler::Work() {
+  worker_context_->make_current();
+  for (;;) {
+    std::function<void()> job;
+    {
+      std::unique_lock lock(mutex_);
+      queue_changed_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        break;
+      }
+      job = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    job();
+    // Destroyed on this thread, the last reference to a job would give its
+    // objects to the pools of the worker, which never collects them
+    std::lock_guard lock(mutex_);
+    finished_.push_back(std::move(job));
+  }
+  worker_context_->release();
+}
+}
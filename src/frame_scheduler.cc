@@ -0,0 +1,121 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/frame_scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+namespace embers {
+namespace {
+FrameScheduler::Clock::duration Period(const double target_rate) {
+  // Also refuses NaN
+  if (!(target_rate > 0)) {
+    throw std::invalid_argument("FrameScheduler: target rate must be above 0");
+  }
+  return std::chrono::duration_cast<FrameScheduler::Clock::duration>(std::chrono::duration<double>(1.0 / target_rate));
+}
+}
+
+FrameScheduler::FrameScheduler(
+  const double target_rate,
+  const Mode mode,
+  const std::chrono::microseconds spin,
+  const std::size_t history
+)
+  : mode_(mode)
+, period_(Period(target_rate))
+, spin_(spin)
+, history_(std::max<std::size_t>(history, 1)) {}
+
+void FrameScheduler::WaitForNextFrame() {
+  Clock::time_point now = Clock::now();
+  if (!started_) {
+    started_ = true;
+    frame_start_ = now;
+    deadline_ = now + period_;
+    return;
+  }
+
+  if (mode_ == Mode::kCapped) {
+    if (now < deadline_) {
+      if (deadline_ - now > spin_) {
+        std::this_thread::sleep_until(deadline_ - spin_);
+      }
+      while ((now = Clock::now()) < deadline_) {
+        std::this_thread::yield();
+      }
+      deadline_ += period_;
+    } else {
+      ++missed_;
+      deadline_ += period_;
+      // More than a frame behind: start over from now rather than rushing
+      // the following frames to catch up
+      if (deadline_ <= now) {
+        deadline_ = now + period_;
+      }
+    }
+  }
+
+  history_[recorded_ % history_.size()] = now - frame_start_;
+  ++recorded_;
+  frame_start_ = now;
+}
+
+void FrameScheduler::SetTargetRate(const double target_rate) {
+  period_ = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / target_rate));
+  started_ = false;
+}
+
+void FrameScheduler::SetMode(const Mode mode) {
+  mode_ = mode;
+  started_ = false;
+}
+
+FrameScheduler::Statistics FrameScheduler::statistics() const {
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+  Statistics statistics;
+  statistics.missed = missed_;
+  statistics.frames = std::min(recorded_, history_.size());
+  if (!statistics.frames) {
+    return statistics;
+  }
+
+  std::vector<double> frames(statistics.frames);
+  std::ranges::transform(
+                         history_.begin(),
+                         history_.begin() + static_cast<std::ptrdiff_t>(statistics.frames),
+                         frames.begin(),
+                         [](const Clock::duration frame) { return Milliseconds(frame).count(); }
+                        );
+  double sum = 0;
+  for (const double frame : frames) {
+    sum += frame;
+  }
+  statistics.mean = sum / static_cast<double>(frames.size());
+  double variance = 0;
+  for (const double frame : frames) {
+    variance += (frame - statistics.mean) * (frame - statistics.mean);
+  }
+  statistics.jitter = std::sqrt(variance / static_cast<double>(frames.size()));
+
+  const auto p99 = frames.begin() + static_cast<std::ptrdiff_t>((frames.size() - 1) * 99 / 100);
+  std::ranges::nth_element(frames, p99);
+  statistics.p99 = *p99;
+  statistics.max = *std::max_element(p99, frames.end());
+  return statistics;
+}
+
+void FrameScheduler::Report(std::ostream &output) const {
+  const Statistics frames = statistics();
+  output << "frames: " << frames.frames
+    << ", mean " << frames.mean << " ms"
+    << ", p99 " << frames.p99 << " ms"
+    << ", max " << frames.max << " ms"
+    << ", jitter " << frames.jitter << " ms"
+    << ", " << frames.missed << " missed deadlines" << std::endl;
+}
+}
@@ -0,0 +1,187 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/gl_handle.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include "embers/gl_state.h"
+
+namespace embers::gl {
+namespace {
+constexpr GLsizei kBatch = 64;
+// Recycled names kept beyond this many are deleted
+constexpr std::size_t kMaxSpare = 256;
+
+struct Traits {
+  // Null for objects the pool cannot create
+  void (*generate)(GLsizei count, GLuint *names);
+  void (*remove)(GLsizei count, const GLuint *names);
+  // Null for objects State does not track
+  void (*forget)(State &state, GLuint name);
+  bool recycle;
+};
+
+// In the order of Kind
+const std::array<Traits, kKinds> kTraits = {{
+  {
+    [](const GLsizei count, GLuint *names) { glGenBuffers(count, names); },
+    [](const GLsizei count, const GLuint *names) { glDeleteBuffers(count, names); },
+    [](State &state, const GLuint name) { state.ForgetBuffer(name); },
+    false
+  },
+  {
+    [](const GLsizei count, GLuint *names) { glGenVertexArrays(count, names); },
+    [](const GLsizei count, const GLuint *names) { glDeleteVertexArrays(count, names); },
+    [](State &state, const GLuint name) { state.ForgetVertexArray(name); },
+    false
+  },
+  {
+    [](const GLsizei count, GLuint *names) { glGenTextures(count, names); },
+    [](const GLsizei count, const GLuint *names) { glDeleteTextures(count, names); },
+    nullptr,
+    false
+  },
+  {
+    [](const GLsizei count, GLuint *names) { glGenFramebuffers(count, names); },
+    [](const GLsizei count, const GLuint *names) { glDeleteFramebuffers(count, names); },
+    nullptr,
+    false
+  },
+  {
+    [](const GLsizei count, GLuint *names) { glGenRenderbuffers(count, names); },
+    [](const GLsizei count, const GLuint *names) { glDeleteRenderbuffers(count, names); },
+    nullptr,
+    false
+  },
+  {
+    [](const GLsizei count, GLuint *names) { glGenQueries(count, names); },
+    [](const GLsizei count, const GLuint *names) { glDeleteQueries(count, names); },
+    nullptr,
+    true
+  },
+  {
+    [](const GLsizei count, GLuint *names) { glGenSamplers(count, names); },
+    [](const GLsizei count, const GLuint *names) { glDeleteSamplers(count, names); },
+    nullptr,
+    false
+  },
+  {
+    nullptr,
+    [](const GLsizei count, const GLuint *names) {
+      for (GLsizei i = 0; i < count; ++i) {
+        glDeleteShader(names[i]);
+      }
+    },
+    nullptr,
+    false
+  },
+  {
+    nullptr,
+    [](const GLsizei count, const GLuint *names) {
+      for (GLsizei i = 0; i < count; ++i) {
+        glDeleteProgram(names[i]);
+      }
+    },
+    [](State &state, const GLuint name) { state.ForgetProgram(name); },
+    false
+  },
+}};
+}
+
+Pool &Pool::Of(const Kind kind) {
+  thread_local Pool pools[kKinds] = {
+    Pool(Kind::kBuffer),
+    Pool(Kind::kVertexArray),
+    Pool(Kind::kTexture),
+    Pool(Kind::kFramebuffer),
+    Pool(Kind::kRenderbuffer),
+    Pool(Kind::kQuery),
+    Pool(Kind::kSampler),
+    Pool(Kind::kShader),
+    Pool(Kind::kProgram),
+  };
+  return pools[static_cast<std::size_t>(kind)];
+}
+
+Pool::Pool(const Kind kind) : kind_(kind) {}
+
+GLuint Pool::Acquire() {
+  if (free_.empty()) {
+    const Traits &traits = kTraits[static_cast<std::size_t>(kind_)];
+    if (!traits.generate) {
+      throw std::logic_error("gl::Pool: shaders and programs are created by GL, not the pool");
+    }
+    free_.resize(kBatch);
+    traits.generate(kBatch, free_.data());
+    ++statistics_.generate_calls;
+    statistics_.generated += kBatch;
+  }
+  const GLuint name = free_.back();
+  free_.pop_back();
+  return name;
+}
+
+void Pool::Release(const GLuint name) {
+  released_.push_back(name);
+}
+
+void Pool::Collect() {
+  if (released_.empty()) {
+    return;
+  }
+  const Traits &traits = kTraits[static_cast<std::size_t>(kind_)];
+  std::size_t first_deleted = 0;
+  if (traits.recycle && free_.size() < kMaxSpare) {
+    first_deleted = std::min(released_.size(), kMaxSpare - free_.size());
+    free_.insert(free_.end(), released_.begin(), released_.begin() + static_cast<std::ptrdiff_t>(first_deleted));
+    statistics_.recycled += first_deleted;
+  }
+  if (first_deleted < released_.size()) {
+    if (traits.forget) {
+      State &state = State::Current();
+      for (std::size_t i = first_deleted; i < released_.size(); ++i) {
+        traits.forget(state, released_[i]);
+      }
+    }
+    const auto count = static_cast<GLsizei>(released_.size() - first_deleted);
+    traits.remove(count, released_.data() + first_deleted);
+    ++statistics_.delete_calls;
+    statistics_.deleted += count;
+  }
+  released_.clear();
+}
+
+void Pool::Trim() {
+  Collect();
+  if (free_.empty()) {
+    return;
+  }
+  const Traits &traits = kTraits[static_cast<std::size_t>(kind_)];
+  if (traits.forget) {
+    State &state = State::Current();
+    for (const GLuint name : free_) {
+      traits.forget(state, name);
+    }
+  }
+  traits.remove(static_cast<GLsizei>(free_.size()), free_.data());
+  ++statistics_.delete_calls;
+  statistics_.deleted += free_.size();
+  free_.clear();
+}
+
+void Collect() {
+  for (std::size_t kind = 0; kind < kKinds; ++kind) {
+    Pool::Of(static_cast<Kind>(kind)).Collect();
+  }
+}
+
+void Trim() {
+  for (std::size_t kind = 0; kind < kKinds; ++kind) {
+    Pool::Of(static_cast<Kind>(kind)).Trim();
+  }
+}
+}
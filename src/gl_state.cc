@@ -0,0 +1,230 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/gl_state.h"
+
+#include <algorithm>
+
+namespace embers::gl {
+namespace {
+// Index of a buffer binding target in State, or -1 if it is not tracked
+int BufferSlot(const GLenum target) {
+  switch (target) {
+    case GL_ARRAY_BUFFER: return 0;
+    case GL_ELEMENT_ARRAY_BUFFER: return 1;
+    case GL_UNIFORM_BUFFER: return 2;
+    case GL_PIXEL_PACK_BUFFER: return 3;
+    case GL_PIXEL_UNPACK_BUFFER: return 4;
+    case GL_COPY_READ_BUFFER: return 5;
+    case GL_COPY_WRITE_BUFFER: return 6;
+    case GL_TEXTURE_BUFFER: return 7;
+    case GL_TRANSFORM_FEEDBACK_BUFFER: return 8;
+    default: return -1;
+  }
+}
+
+int CapabilitySlot(const GLenum capability) {
+  switch (capability) {
+    case GL_BLEND: return 0;
+    case GL_CULL_FACE: return 1;
+    case GL_DEPTH_TEST: return 2;
+    case GL_SCISSOR_TEST: return 3;
+    case GL_STENCIL_TEST: return 4;
+    case GL_POLYGON_OFFSET_FILL: return 5;
+    case GL_MULTISAMPLE: return 6;
+    case GL_FRAMEBUFFER_SRGB: return 7;
+    case GL_PRIMITIVE_RESTART: return 8;
+    case GL_PROGRAM_POINT_SIZE: return 9;
+    default: return -1;
+  }
+}
+}
+
+State &State::Current() {
+  thread_local State state;
+  return state;
+}
+
+State::State() {
+  Invalidate();
+}
+
+void State::Invalidate() {
+  program_ = kUnknown;
+  vertex_array_ = kUnknown;
+  buffers_.fill(kUnknown);
+  uniform_buffers_.fill(kUnknown);
+  capabilities_.fill(-1);
+  blend_func_ = {kUnknown, kUnknown};
+  depth_func_ = kUnknown;
+  depth_mask_ = -1;
+  cull_face_ = kUnknown;
+  clear_color_known_ = false;
+  viewport_ = {0, 0, -1, -1};
+}
+
+bool State::Hit(const bool hit) {
+  if (hit) {
+    ++statistics_.hits;
+  } else {
+    ++statistics_.misses;
+  }
+  return hit;
+}
+
+void State::UseProgram(const GLuint program) {
+  if (Hit(program_ == program)) {
+    return;
+  }
+  program_ = program;
+  glUseProgram(program);
+}
+
+void State::BindVertexArray(const GLuint vertex_array) {
+  if (Hit(vertex_array_ == vertex_array)) {
+    return;
+  }
+  vertex_array_ = vertex_array;
+  buffers_[BufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = kUnknown;
+  glBindVertexArray(vertex_array);
+}
+
+void State::BindBuffer(const GLenum target, const GLuint buffer) {
+  const int slot = BufferSlot(target);
+  if (Hit(slot >= 0 && buffers_[slot] == buffer)) {
+    return;
+  }
+  if (slot >= 0) {
+    buffers_[slot] = buffer;
+  }
+  glBindBuffer(target, buffer);
+}
+
+void State::BindBufferBase(const GLenum target, const GLuint index, const GLuint buffer) {
+  const bool tracked = target == GL_UNIFORM_BUFFER && index < kIndexedBindings;
+  if (Hit(tracked && uniform_buffers_[index] == buffer && buffers_[BufferSlot(target)] == buffer)) {
+    return;
+  }
+  if (tracked) {
+    uniform_buffers_[index] = buffer;
+  }
+  if (const int slot = BufferSlot(target); slot >= 0) {
+    buffers_[slot] = buffer;
+  }
+  glBindBufferBase(target, index, buffer);
+}
+
+void State::BindBufferRange(
+  const GLenum target,
+  const GLuint index,
+  const GLuint buffer,
+  const GLintptr offset,
+  const GLsizeiptr size
+) {
+  Hit(false);
+  // A later BindBufferBase of the same buffer still has to bind all of it
+  if (target == GL_UNIFORM_BUFFER && index < kIndexedBindings) {
+    uniform_buffers_[index] = kUnknown;
+  }
+  if (const int slot = BufferSlot(target); slot >= 0) {
+    buffers_[slot] = buffer;
+  }
+  glBindBufferRange(target, index, buffer, offset, size);
+}
+
+void State::Enable(const GLenum capability) {
+  SetCapability(capability, true);
+}
+
+void State::Disable(const GLenum capability) {
+  SetCapability(capability, false);
+}
+
+void State::SetCapability(const GLenum capability, const bool enabled) {
+  const int slot = CapabilitySlot(capability);
+  if (Hit(slot >= 0 && capabilities_[slot] == enabled)) {
+    return;
+  }
+  if (slot >= 0) {
+    capabilities_[slot] = enabled;
+  }
+  if (enabled) {
+    glEnable(capability);
+  } else {
+    glDisable(capability);
+  }
+}
+
+void State::BlendFunc(const GLenum source, const GLenum destination) {
+  if (Hit(blend_func_[0] == source && blend_func_[1] == destination)) {
+    return;
+  }
+  blend_func_ = {source, destination};
+  glBlendFunc(source, destination);
+}
+
+void State::DepthFunc(const GLenum function) {
+  if (Hit(depth_func_ == function)) {
+    return;
+  }
+  depth_func_ = function;
+  glDepthFunc(function);
+}
+
+void State::DepthMask(const GLboolean enabled) {
+  if (Hit(depth_mask_ == enabled)) {
+    return;
+  }
+  depth_mask_ = enabled;
+  glDepthMask(enabled);
+}
+
+void State::CullFace(const GLenum face) {
+  if (Hit(cull_face_ == face)) {
+    return;
+  }
+  cull_face_ = face;
+  glCullFace(face);
+}
+
+void State::ClearColor(const GLfloat red, const GLfloat green, const GLfloat blue, const GLfloat alpha) {
+  const std::array color = {red, green, blue, alpha};
+  if (Hit(clear_color_known_ && clear_color_ == color)) {
+    return;
+  }
+  clear_color_known_ = true;
+  clear_color_ = color;
+  glClearColor(red, green, blue, alpha);
+}
+
+void State::Viewport(const GLint x, const GLint y, const GLsizei width, const GLsizei height) {
+  const std::array viewport = {x, y, width, height};
+  if (Hit(viewport_ == viewport)) {
+    return;
+  }
+  viewport_ = viewport;
+  glViewport(x, y, width, height);
+}
+
+void State::ForgetProgram(const GLuint program) {
+  // A deleted program stays in use until another one is, so only forget it
+  if (program_ == program) {
+    program_ = kUnknown;
+  }
+}
+
+void State::ForgetVertexArray(const GLuint vertex_array) {
+  // Deleting the bound vertex array binds 0 instead
+  if (vertex_array_ == vertex_array) {
+    vertex_array_ = 0;
+    buffers_[BufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = 0;
+  }
+}
+
+void State::ForgetBuffer(const GLuint buffer) {
+  // Deleting a bound buffer resets every binding to it in this context to 0
+  std::ranges::replace(buffers_, buffer, GLuint(0));
+  std::ranges::replace(uniform_buffers_, buffer, GLuint(0));
+}
+}
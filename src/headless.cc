@@ -0,0 +1,207 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/headless.h"
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "embers/gl_handle.h"
+#include "embers/gl_state.h"
+
+namespace embers {
+namespace {
+constexpr EGLint kContextAttributes[] = {
+  EGL_CONTEXT_MAJOR_VERSION, 3,
+  EGL_CONTEXT_MINOR_VERSION, 3,
+  EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+  EGL_NONE
+};
+
+constexpr EGLint kConfigAttributes[] = {
+  EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+  EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+  EGL_RED_SIZE, 8,
+  EGL_GREEN_SIZE, 8,
+  EGL_BLUE_SIZE, 8,
+  EGL_NONE
+};
+
+constexpr EGLint kPbufferAttributes[] = {
+  EGL_WIDTH, 1,
+  EGL_HEIGHT, 1,
+  EGL_NONE
+};
+
+[[noreturn]] void ThrowEglError(const char *call) {
+  throw std::runtime_error(std::string("Headless: ") + call + " failed with EGL error " + std::to_string(eglGetError()));
+}
+
+bool HasExtension(const char *extensions, const std::string_view name) {
+  if (!extensions) {
+    return false;
+  }
+  std::string_view list(extensions);
+  while (!list.empty()) {
+    const std::size_t end = list.find(' ');
+    if (list.substr(0, end) == name) {
+      return true;
+    }
+    list.remove_prefix(end == std::string_view::npos ? list.size() : end + 1);
+  }
+  return false;
+}
+
+EGLDisplay OpenDisplay() {
+  // Client extensions, queried without a display
+  if (HasExtension(eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS), "EGL_MESA_platform_surfaceless")) {
+    const auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+      eglGetProcAddress("eglGetPlatformDisplayEXT")
+    );
+    if (get_platform_display) {
+      if (EGLDisplay display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)) {
+        return display;
+      }
+    }
+  }
+  return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+}
+
+Headless::Headless(const int width, const int height)
+  : width_(width)
+, height_(height) {
+  try {
+    EGLDisplay display = OpenDisplay();
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+      ThrowEglError("eglInitialize");
+    }
+    display_ = display;
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+      ThrowEglError("eglBindAPI");
+    }
+
+    const char *extensions = eglQueryString(display, EGL_EXTENSIONS);
+    const bool surfaceless = HasExtension(extensions, "EGL_KHR_surfaceless_context");
+    EGLConfig config = nullptr;
+    EGLint configs = 0;
+    if (!eglChooseConfig(display, kConfigAttributes, &config, 1, &configs) || configs == 0) {
+      // Rendering only goes to our framebuffer, so a surfaceless context
+      // does not need a config
+      if (!surfaceless || !HasExtension(extensions, "EGL_KHR_no_config_context")) {
+        ThrowEglError("eglChooseConfig");
+      }
+      config = EGL_NO_CONFIG_KHR;
+    }
+    config_ = config;
+
+    context_ = eglCreateContext(display, config, EGL_NO_CONTEXT, kContextAttributes);
+    if (!context_) {
+      ThrowEglError("eglCreateContext");
+    }
+    if (!surfaceless) {
+      surface_ = eglCreatePbufferSurface(display, config, kPbufferAttributes);
+      if (!surface_) {
+        ThrowEglError("eglCreatePbufferSurface");
+      }
+    }
+    if (!eglMakeCurrent(display, surface_, surface_, context_)) {
+      ThrowEglError("eglMakeCurrent");
+    }
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress))) {
+      throw std::runtime_error("Headless: could not load OpenGL");
+    }
+
+    gl::State &state = gl::State::Current();
+    state.Invalidate();
+    glGenRenderbuffers(1, &color_);
+    glBindRenderbuffer(GL_RENDERBUFFER, color_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width_, height_);
+    glGenRenderbuffers(1, &depth_stencil_);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth_stencil_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width_, height_);
+    glGenFramebuffers(1, &framebuffer_);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_stencil_);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+      throw std::runtime_error("Headless: framebuffer is incomplete");
+    }
+    state.Viewport(0, 0, width_, height_);
+  } catch (...) {
+    Release();
+    throw;
+  }
+}
+
+Headless::~Headless() {
+  Release();
+}
+
+void Headless::Release() {
+  if (context_ && eglGetCurrentContext() == context_) {
+    // Objects given back to the pools belong to this context
+    gl::Trim();
+    glDeleteFramebuffers(1, &framebuffer_);
+    glDeleteRenderbuffers(1, &color_);
+    glDeleteRenderbuffers(1, &depth_stencil_);
+    gl::State::Current().Invalidate();
+  }
+  if (!display_) {
+    return;
+  }
+  eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  for (void *context : {shared_context_, context_}) {
+    if (context) {
+      eglDestroyContext(display_, context);
+    }
+  }
+  for (void *surface : {shared_surface_, surface_}) {
+    if (surface) {
+      eglDestroySurface(display_, surface);
+    }
+  }
+  eglTerminate(display_);
+  display_ = nullptr;
+  context_ = shared_context_ = nullptr;
+  surface_ = shared_surface_ = nullptr;
+}
+
+shader::SharedContext *Headless::CompileContext() {
+  if (shared_context_) {
+    return &shared_;
+  }
+  shared_context_ = eglCreateContext(display_, config_, context_, kContextAttributes);
+  if (!shared_context_) {
+    ThrowEglError("eglCreateContext");
+  }
+  if (surface_) {
+    shared_surface_ = eglCreatePbufferSurface(display_, config_, kPbufferAttributes);
+    if (!shared_surface_) {
+      ThrowEglError("eglCreatePbufferSurface");
+    }
+  }
+  shared_ = {
+    [this] {
+      eglMakeCurrent(display_, shared_surface_, shared_surface_, shared_context_);
+    },
+    [this] {
+      eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+  };
+  return &shared_;
+}
+
+std::vector<std::uint8_t> Headless::ReadPixels() const {
+  std::vector<std::uint8_t> pixels(static_cast<std::size_t>(width_) * height_ * 4);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer_);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  gl::State::Current().BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  glReadPixels(0, 0, width_, height_, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+  return pixels;
+}
+}
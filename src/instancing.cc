@@ -0,0 +1,35 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/instancing.h"
+
+#include <cmath>
+
+namespace embers::render {
+Instance2D Instance2D::At(
+  const GLfloat x,
+  const GLfloat y,
+  const GLfloat rotation,
+  const GLfloat scale,
+  const Color color
+) {
+  const GLfloat cos = std::cos(rotation) * scale;
+  const GLfloat sin = std::sin(rotation) * scale;
+  return {
+    {cos, -sin, x},
+    {sin, cos, y},
+    color
+  };
+}
+
+Instance3D Instance3D::From(const GLfloat (&matrix)[16], const Color color) {
+  return {
+    {matrix[0], matrix[1], matrix[2], matrix[3]},
+    {matrix[4], matrix[5], matrix[6], matrix[7]},
+    {matrix[8], matrix[9], matrix[10], matrix[11]},
+    {matrix[12], matrix[13], matrix[14], matrix[15]},
+    color
+  };
+}
+}
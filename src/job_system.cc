@@ -0,0 +1,169 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/job_system.h"
+
+#include <algorithm>
+#include <optional>
+
+namespace embers {
+namespace {
+// The system the current thread works for, and its deque there
+thread_local const JobSystem *current_system = nullptr;
+thread_local unsigned current_queue = 0;
+}
+
+unsigned JobSystem::DefaultThreads() {
+  return std::max(std::thread::hardware_concurrency(), 2u) - 1;
+}
+
+JobSystem::JobSystem(const unsigned threads) {
+  queues_.reserve(threads + 1);
+  for (unsigned i = 0; i <= threads; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  workers_.reserve(threads);
+  for (unsigned i = 1; i <= threads; ++i) {
+    workers_.emplace_back(&JobSystem::Work, this, i);
+  }
+}
+
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard lock(sleep_mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread &worker : workers_) {
+    worker.join();
+  }
+}
+
+unsigned JobSystem::ThreadIndex() const {
+  return current_system == this ? current_queue : 0;
+}
+
+void JobSystem::Run(const std::size_t count, const std::size_t grain, const Function function, void *body) {
+  const std::size_t chunk = std::max<std::size_t>(grain, 1);
+  if (count <= chunk || workers_.empty()) {
+    for (std::size_t begin = 0; begin < count; begin += chunk) {
+      function(body, begin, std::min(begin + chunk, count));
+    }
+    return;
+  }
+
+  const std::size_t chunks = (count + chunk - 1) / chunk;
+  Batch batch;
+  batch.pending.store(chunks, std::memory_order_relaxed);
+  const unsigned queue = ThreadIndex();
+  {
+    // Reversed, so the owner popping from the back starts at the beginning
+    // and thieves take the far end
+    std::lock_guard lock(queues_[queue]->mutex);
+    for (std::size_t i = chunks; i-- > 0;) {
+      queues_[queue]->jobs.push_back({function, body, i * chunk, std::min((i + 1) * chunk, count), &batch});
+    }
+  }
+  queued_.fetch_add(chunks, std::memory_order_release);
+  {
+    std::lock_guard lock(sleep_mutex_);
+  }
+  wake_.notify_all();
+
+  // Jobs of other batches may run here too, which keeps every thread busy
+  while (batch.pending.load(std::memory_order_acquire) != 0) {
+    if (!RunOne(queue)) {
+      std::this_thread::yield();
+    }
+  }
+  if (batch.error) {
+    std::rethrow_exception(batch.error);
+  }
+}
+
+void JobSystem::SpawnTask(std::unique_ptr<std::function<void()>> task) {
+  if (workers_.empty()) {
+    (*task)();
+    return;
+  }
+  const Job job = {
+    [](void *body, std::size_t, std::size_t) {
+      const std::unique_ptr<std::function<void()>> task(static_cast<std::function<void()> *>(body));
+      (*task)();
+    },
+    task.release(),
+    0,
+    0,
+    nullptr
+  };
+  const unsigned queue = ThreadIndex();
+  {
+    std::lock_guard lock(queues_[queue]->mutex);
+    queues_[queue]->jobs.push_back(job);
+  }
+  queued_.fetch_add(1, std::memory_order_release);
+  {
+    std::lock_guard lock(sleep_mutex_);
+  }
+  wake_.notify_one();
+}
+
+bool JobSystem::RunOne(const unsigned queue) {
+  std::optional<Job> job;
+  {
+    Queue &own = *queues_[queue];
+    std::lock_guard lock(own.mutex);
+    if (!own.jobs.empty()) {
+      job = own.jobs.back();
+      own.jobs.pop_back();
+    }
+  }
+  for (std::size_t i = 1; !job && i < queues_.size(); ++i) {
+    Queue &victim = *queues_[(queue + i) % queues_.size()];
+    std::lock_guard lock(victim.mutex);
+    if (!victim.jobs.empty()) {
+      job = victim.jobs.front();
+      victim.jobs.pop_front();
+      steals_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  if (!job) {
+    return false;
+  }
+  queued_.fetch_sub(1, std::memory_order_relaxed);
+  jobs_.fetch_add(1, std::memory_order_relaxed);
+
+  if (!job->batch) {
+    job->function(job->body, job->begin, job->end);
+    return true;
+  }
+  Batch &batch = *job->batch;
+  try {
+    job->function(job->body, job->begin, job->end);
+  } catch (...) {
+    if (!batch.failed.exchange(true)) {
+      batch.error = std::current_exception();
+    }
+  }
+  // The batch is gone once its caller sees nothing pending
+  batch.pending.fetch_sub(1, std::memory_order_acq_rel);
+  return true;
+}
+
+void JobSystem::Work(const unsigned queue) {
+  current_system = this;
+  current_queue = queue;
+  while (true) {
+    if (RunOne(queue)) {
+      continue;
+    }
+    std::unique_lock lock(sleep_mutex_);
+    wake_.wait(lock, [this] { return stopping_ || queued_.load(std::memory_order_acquire) != 0; });
+    // Spawned tasks still queued are run before stopping
+    if (stopping_ && queued_.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+  }
+}
+}
@@ -0,0 +1,62 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/mapped_file.h"
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace embers {
+MappedFile::MappedFile(const std::filesystem::path &path) {
+  const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file < 0) {
+    throw std::system_error(errno, std::generic_category(), path.string());
+  }
+  struct stat status{};
+  if (fstat(file, &status) != 0) {
+    const int error = errno;
+    close(file);
+    throw std::system_error(error, std::generic_category(), path.string());
+  }
+  size_ = static_cast<std::size_t>(status.st_size);
+  // Zero-length mappings are invalid, an empty file is just an empty view
+  if (size_) {
+    void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+    if (data == MAP_FAILED) {
+      const int error = errno;
+      close(file);
+      throw std::system_error(error, std::generic_category(), path.string());
+    }
+    data_ = static_cast<const char *>(data);
+  }
+  // The mapping keeps the file alive on its own
+  close(file);
+}
+
+MappedFile::MappedFile(MappedFile &&file) noexcept
+  : data_(std::exchange(file.data_, nullptr))
+, size_(std::exchange(file.size_, 0)) {}
+
+MappedFile::~MappedFile() {
+  if (data_) {
+    munmap(const_cast<char *>(data_), size_);
+  }
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&file) noexcept {
+  if (this != &file) {
+    if (data_) {
+      munmap(const_cast<char *>(data_), size_);
+    }
+    data_ = std::exchange(file.data_, nullptr);
+    size_ = std::exchange(file.size_, 0);
+  }
+  return *this;
+}
+}
@@ -0,0 +1,214 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/profiler.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace embers::profile {
+namespace {
+constexpr std::uint32_t kGpuTrack = 0;
+constexpr GLsizei kQueryBatch = 64;
+
+double Milliseconds(const Profiler::Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+double Microseconds(const Profiler::Clock::duration duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+void WriteString(std::ostream &output, const std::string_view text) {
+  output << '"';
+  for (const char c : text) {
+    if (c == '"' || c == '\\') {
+      output << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      output << ' ';
+    } else {
+      output << c;
+    }
+  }
+  output << '"';
+}
+}
+
+Profiler &Profiler::Global() {
+  static Profiler profiler;
+  return profiler;
+}
+
+Profiler::Profiler(const unsigned latency, const std::size_t max_events)
+  : latency_(latency)
+, max_events_(max_events)
+, epoch_(Clock::now()) {}
+
+void Profiler::Reset() {
+  if (!all_queries_.empty()) {
+    glDeleteQueries(static_cast<GLsizei>(all_queries_.size()), all_queries_.data());
+  }
+  all_queries_.clear();
+  free_queries_.clear();
+  first_gpu_zone_ += gpu_pending_.size();
+  gpu_pending_.clear();
+  gpu_calibration_ = -1;
+
+  std::lock_guard lock(mutex_);
+  cpu_zones_.clear();
+  gpu_zones_.clear();
+  events_.clear();
+  dropped_events_ = 0;
+}
+
+void Profiler::Enable(const bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::Record(std::unordered_map<std::string_view, Accumulator> &zones, const Event &event) {
+  Accumulator &zone = zones[event.name];
+  ++zone.count;
+  zone.total += event.duration;
+  zone.max = std::max(zone.max, event.duration);
+  if (events_.size() < max_events_) {
+    events_.push_back(event);
+  } else {
+    ++dropped_events_;
+  }
+}
+
+void Profiler::RecordCpu(const std::string_view name, const Clock::time_point start, const Clock::time_point end) {
+  std::lock_guard lock(mutex_);
+  const auto [track, inserted] = tracks_.try_emplace(
+    std::this_thread::get_id(),
+    static_cast<std::uint32_t>(tracks_.size() + 1)
+  );
+  Record(cpu_zones_, {name, track->second, start - epoch_, end - start});
+}
+
+GLuint Profiler::AcquireQuery() {
+  if (free_queries_.empty()) {
+    // Generated in batches, so queries are rarely created on the hot path
+    GLuint queries[kQueryBatch];
+    glGenQueries(kQueryBatch, queries);
+    free_queries_.assign(std::begin(queries), std::end(queries));
+    all_queries_.insert(all_queries_.end(), std::begin(queries), std::end(queries));
+  }
+  const GLuint query = free_queries_.back();
+  free_queries_.pop_back();
+  return query;
+}
+
+std::size_t Profiler::BeginGpu(const std::string_view name) {
+  if (gpu_calibration_ < 0) {
+    glGetInteger64v(GL_TIMESTAMP, &gpu_calibration_);
+    gpu_calibration_cpu_ = Clock::now();
+  }
+  const GLuint begin = AcquireQuery();
+  glQueryCounter(begin, GL_TIMESTAMP);
+  gpu_pending_.push_back({name, begin, 0, frame_, false});
+  return first_gpu_zone_ + gpu_pending_.size() - 1;
+}
+
+void Profiler::EndGpu(const std::size_t zone) {
+  // The zone is gone if Reset was called in the meantime
+  if (zone < first_gpu_zone_) {
+    return;
+  }
+  PendingGpuZone &pending = gpu_pending_[zone - first_gpu_zone_];
+  pending.end = AcquireQuery();
+  glQueryCounter(pending.end, GL_TIMESTAMP);
+  pending.ended = true;
+}
+
+void Profiler::EndFrame() {
+  ++frame_;
+  // Timestamps complete in order, so the first zone not done ends the scan
+  while (!gpu_pending_.empty()) {
+    const PendingGpuZone &zone = gpu_pending_.front();
+    if (!zone.ended || zone.frame + latency_ > frame_) {
+      break;
+    }
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(zone.end, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE) {
+      break;
+    }
+    GLuint64 begin = 0;
+    GLuint64 end = 0;
+    glGetQueryObjectui64v(zone.begin, GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(zone.end, GL_QUERY_RESULT, &end);
+    const auto since_calibration = std::chrono::nanoseconds(static_cast<GLint64>(begin) - gpu_calibration_);
+    const Event event = {
+      zone.name,
+      kGpuTrack,
+      gpu_calibration_cpu_ - epoch_ + std::chrono::duration_cast<Clock::duration>(since_calibration),
+      std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(end - begin))
+    };
+    {
+      std::lock_guard lock(mutex_);
+      Record(gpu_zones_, event);
+    }
+    free_queries_.push_back(zone.begin);
+    free_queries_.push_back(zone.end);
+    gpu_pending_.pop_front();
+    ++first_gpu_zone_;
+  }
+}
+
+std::vector<Profiler::ZoneStatistics> Profiler::statistics() const {
+  std::vector<ZoneStatistics> statistics;
+  {
+    std::lock_guard lock(mutex_);
+    for (const bool gpu : {false, true}) {
+      for (const auto &[name, zone] : gpu ? gpu_zones_ : cpu_zones_) {
+        statistics.push_back({
+          name,
+          gpu,
+          zone.count,
+          Milliseconds(zone.total),
+          Milliseconds(zone.total) / static_cast<double>(zone.count),
+          Milliseconds(zone.max)
+        });
+      }
+    }
+  }
+  std::ranges::sort(statistics, std::ranges::greater(), &ZoneStatistics::total);
+  return statistics;
+}
+
+void Profiler::Report(std::ostream &output) const {
+  for (const ZoneStatistics &zone : statistics()) {
+    output << (zone.gpu ? "gpu " : "cpu ") << zone.name << ": " << zone.count << " times"
+      << ", mean " << zone.mean << " ms"
+      << ", max " << zone.max << " ms"
+      << ", total " << zone.total << " ms" << std::endl;
+  }
+}
+
+void Profiler::WriteTrace(std::ostream &output) const {
+  std::lock_guard lock(mutex_);
+  const auto precision = output.precision(3);
+  const auto flags = output.setf(std::ios::fixed, std::ios::floatfield);
+
+  output << "{\"traceEvents\":[\n";
+  output << R"({"name":"thread_name","ph":"M","pid":1,"tid":0,"args":{"name":"GPU"}})";
+  for (const auto &[thread, track] : tracks_) {
+    output << ",\n" << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << track
+      << R"(,"args":{"name":"CPU )" << track << "\"}}";
+  }
+  for (const Event &event : events_) {
+    output << ",\n{\"name\":";
+    WriteString(output, event.name);
+    output << ",\"cat\":\"" << (event.track == kGpuTrack ? "gpu" : "cpu") << '"'
+      << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.track
+      << ",\"ts\":" << Microseconds(event.start)
+      << ",\"dur\":" << Microseconds(event.duration) << '}';
+  }
+  output << "\n],\"otherData\":{\"dropped_events\":" << dropped_events_ << "}}" << std::endl;
+
+  output.precision(precision);
+  output.flags(flags);
+}
+}
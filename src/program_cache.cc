@@ -0,0 +1,179 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/program_cache.h"
+
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+#include "embers/hash.h"
+#include "embers/shader.h"
+
+namespace embers::shader {
+namespace {
+constexpr std::array<char, 4> kMagic = {'E', 'M', 'B', 'P'};
+constexpr std::uint32_t kVersion = 1;
+
+struct Header {
+  std::array<char, 4> magic;
+  std::uint32_t version;
+  std::uint64_t key;
+  std::uint32_t format;
+  std::uint32_t length;
+};
+
+std::string_view GetString(const GLenum name) {
+  const auto *string = reinterpret_cast<const char *>(glGetString(name));
+  return string ? std::string_view(string) : std::string_view();
+}
+
+std::uint64_t HashValue(const std::uint32_t value, const std::uint64_t hash) {
+  return Fnv1a(std::string_view(reinterpret_cast<const char *>(&value), sizeof(value)), hash);
+}
+}
+
+ProgramCache::ProgramCache(std::filesystem::path directory)
+  : directory_(std::move(directory))
+, driver_hash_(kFnvOffsetBasis)
+, supported_(false) {
+  for (const GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+    driver_hash_ = Fnv1a(GetString(name), driver_hash_);
+    driver_hash_ = Fnv1a(std::string_view("\0", 1), driver_hash_);
+  }
+  GLint formats = 0;
+  if (GLAD_GL_ARB_get_program_binary) {
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  }
+  std::error_code error;
+  std::filesystem::create_directories(directory_, error);
+  supported_ = formats > 0 && !error;
+}
+
+std::uint64_t ProgramCache::Key(const std::span<const Source *const> sources) const {
+  std::uint64_t hash = driver_hash_;
+  for (const Source *source : sources) {
+    // Hashes the joined text, however it is split into fragments
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < source->fragment_count(); ++i) {
+      size += source->fragment(i).size();
+    }
+    hash = HashValue(source->type(), hash);
+    hash = HashValue(static_cast<std::uint32_t>(size), hash);
+    for (std::size_t i = 0; i < source->fragment_count(); ++i) {
+      hash = Fnv1a(source->fragment(i), hash);
+    }
+  }
+  return hash;
+}
+
+bool ProgramCache::Load(const GLuint program, const std::uint64_t key) {
+  if (!supported_) {
+    return false;
+  }
+  const std::filesystem::path path = PathOf(key);
+  std::ifstream input(path, std::ios::binary);
+  if (!input) {
+    return false;
+  }
+  Header header{};
+  input.read(reinterpret_cast<char *>(&header), sizeof(header));
+  if (!input || header.magic != kMagic || header.version != kVersion || header.key != key) {
+    return false;
+  }
+  // A corrupt or truncated file could otherwise ask for any length
+  std::error_code error;
+  const std::uintmax_t size = std::filesystem::file_size(path, error);
+  if (error || size != sizeof(header) + std::uintmax_t{header.length}) {
+    return false;
+  }
+  const auto binary = std::make_unique<char[]>(header.length);
+  input.read(binary.get(), header.length);
+  if (!input) {
+    return false;
+  }
+
+  glProgramBinary(program, header.format, binary.get(), static_cast<GLsizei>(header.length));
+  GLint success = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  if (success == GL_FALSE) {
+    // Stale or foreign binary, drop it so the next Store replaces it
+    ++statistics_.rejected;
+    std::filesystem::remove(path, error);
+    return false;
+  }
+  return true;
+}
+
+void ProgramCache::Store(const GLuint program, const std::uint64_t key) const {
+  if (!supported_) {
+    return;
+  }
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return;
+  }
+  Header header{kMagic, kVersion, key, 0, 0};
+  const auto binary = std::make_unique<char[]>(length);
+  GLsizei written = 0;
+  GLenum format = 0;
+  glGetProgramBinary(program, length, &written, &format, binary.get());
+  header.format = format;
+  header.length = static_cast<std::uint32_t>(written);
+
+  // Write aside and rename, so a concurrent reader never sees half a file.
+  // Every writer has its own temporary, or two storing the same key could
+  // rename a mix of both into place
+  static std::atomic<std::uint32_t> writes = 0;
+  const std::filesystem::path path = PathOf(key);
+  std::filesystem::path temporary = path;
+  temporary += "." + std::to_string(getpid()) + "." + std::to_string(writes++) + ".tmp";
+  std::error_code error;
+  {
+    std::ofstream output(temporary, std::ios::binary | std::ios::trunc);
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    output.write(binary.get(), written);
+    if (!output) {
+      output.close();
+      std::filesystem::remove(temporary, error);
+      return;
+    }
+  }
+  std::filesystem::rename(temporary, path, error);
+  if (error) {
+    std::filesystem::remove(temporary, error);
+  }
+}
+
+void ProgramCache::Record(const bool hit, const std::chrono::nanoseconds time) {
+  if (hit) {
+    ++statistics_.hits;
+    statistics_.hit_time += time;
+  } else {
+    ++statistics_.misses;
+    statistics_.miss_time += time;
+  }
+}
+
+void ProgramCache::Report(std::ostream &output) const {
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+  output << "program cache: "
+    << statistics_.hits << " hits in " << Milliseconds(statistics_.hit_time).count() << " ms, "
+    << statistics_.misses << " misses in " << Milliseconds(statistics_.miss_time).count() << " ms, "
+    << statistics_.rejected << " rejected"
+    << (supported_ ? "" : " (unsupported by driver)") << std::endl;
+}
+
+std::filesystem::path ProgramCache::PathOf(const std::uint64_t key) const {
+  std::ostringstream name;
+  name << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+  return directory_ / name.str();
+}
+}
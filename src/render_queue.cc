@@ -0,0 +1,338 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/render_queue.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+#include "embers/gl_state.h"
+#include "embers/hash.h"
+
+namespace embers::render {
+namespace {
+// Key layout, from the most significant bits: program slot, vertex array
+// slot, uniform set, index type, primitive mode, packet index
+constexpr int kPacketBits = 20;
+constexpr int kModeShift = kPacketBits;
+constexpr int kTypeShift = kModeShift + 4;
+constexpr int kUniformsShift = kTypeShift + 2;
+constexpr int kVertexArrayShift = kUniformsShift + 14;
+constexpr int kProgramShift = kVertexArrayShift + 12;
+constexpr int kRadixBits = 8;
+constexpr int kRadixPasses = (64 - kPacketBits + kRadixBits - 1) / kRadixBits;
+
+constexpr std::uint64_t Field(const std::uint64_t key, const int shift, const int bits) {
+  return key >> shift & ((std::uint64_t(1) << bits) - 1);
+}
+
+// Index types in key order; 0 stands for an array draw
+constexpr std::array<GLenum, 4> kIndexTypes = {GL_NONE, GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT};
+
+std::uint64_t IndexTypeBits(const GLenum type) {
+  const auto found = std::ranges::find(kIndexTypes, type);
+  if (found == kIndexTypes.end()) {
+    throw std::invalid_argument("render::Queue: unsupported index type");
+  }
+  return found - kIndexTypes.begin();
+}
+
+std::size_t IndexSize(const GLenum type) {
+  switch (type) {
+    case GL_UNSIGNED_BYTE:
+      return 1;
+    case GL_UNSIGNED_SHORT:
+      return 2;
+    default:
+      return 4;
+  }
+}
+
+// Vertices per primitive of the modes whose consecutive ranges can be drawn
+// as one, 0 for the others
+GLsizei ListVertices(const GLenum mode) {
+  switch (mode) {
+    case GL_POINTS:
+      return 1;
+    case GL_LINES:
+      return 2;
+    case GL_TRIANGLES:
+      return 3;
+    default:
+      return 0;
+  }
+}
+
+template<typename Map, typename Value>
+std::uint32_t Slot(Map &slots, std::vector<Value> &values, const Value value, const std::size_t limit) {
+  const auto [slot, inserted] = slots.try_emplace(value, static_cast<std::uint32_t>(values.size()));
+  if (inserted) {
+    if (values.size() == limit) {
+      slots.erase(slot);
+      throw std::length_error("render::Queue: too many distinct objects before Submit");
+    }
+    values.push_back(value);
+  }
+  return slot->second;
+}
+}
+
+// UniformValue
+
+UniformValue::UniformValue(const shader::Uniform<GLboolean> uniform, const GLboolean value)
+  : value_(std::in_place_index<0>, uniform, value) {}
+
+UniformValue::UniformValue(const shader::Uniform<GLint> uniform, const GLint value)
+  : value_(std::in_place_index<1>, uniform, value) {}
+
+UniformValue::UniformValue(const shader::Uniform<GLfloat> uniform, const GLfloat value)
+  : value_(std::in_place_index<2>, uniform, value) {}
+
+void UniformValue::Apply(shader::Program &program) const {
+  std::visit([&program](const auto &value) { program.setUniform(value.first, value.second); }, value_);
+}
+
+std::uint64_t UniformValue::hash() const {
+  return std::visit(
+    [this](const auto &value) {
+      std::array<char, 9> bytes{};
+      bytes[0] = static_cast<char>(value_.index());
+      const auto handle = std::bit_cast<std::uint32_t>(value.first);
+      std::memcpy(&bytes[1], &handle, sizeof(handle));
+      std::memcpy(&bytes[5], &value.second, sizeof(value.second));
+      return Fnv1a(std::string_view(bytes.data(), bytes.size()));
+    },
+    value_
+  );
+}
+
+// Queue
+
+UniformSet Queue::Uniforms(const std::initializer_list<UniformValue> values) {
+  if (values.size() == 0) {
+    return kNoUniforms;
+  }
+  std::uint64_t hash = kFnvOffsetBasis;
+  for (const UniformValue &value : values) {
+    hash = (hash ^ value.hash()) * kFnvPrime;
+  }
+  const auto [first, last] = uniform_set_hashes_.equal_range(hash);
+  for (auto candidate = first; candidate != last; ++candidate) {
+    const Range range = uniform_sets_[candidate->second - 1];
+    if (std::equal(
+      values.begin(),
+      values.end(),
+      uniform_values_.begin() + range.begin,
+      uniform_values_.begin() + range.end
+    )) {
+      return candidate->second;
+    }
+  }
+
+  if (uniform_sets_.size() == kMaxUniformSets) {
+    throw std::length_error("render::Queue: too many uniform sets before Submit");
+  }
+  const auto begin = static_cast<std::uint32_t>(uniform_values_.size());
+  uniform_values_.insert(uniform_values_.end(), values.begin(), values.end());
+  uniform_sets_.push_back({begin, static_cast<std::uint32_t>(uniform_values_.size())});
+  const auto set = static_cast<UniformSet>(uniform_sets_.size());
+  uniform_set_hashes_.emplace(hash, set);
+  return set;
+}
+
+void Queue::DrawArrays(
+  shader::Program &program,
+  const GLuint vertex_array,
+  const GLenum mode,
+  const GLint first,
+  const GLsizei count,
+  const UniformSet uniforms
+) {
+  Push(program, vertex_array, mode, GL_NONE, first, count, uniforms);
+}
+
+void Queue::DrawElements(
+  shader::Program &program,
+  const GLuint vertex_array,
+  const GLenum mode,
+  const GLsizei count,
+  const GLenum type,
+  const std::size_t offset,
+  const UniformSet uniforms
+) {
+  if (type == GL_NONE) {
+    throw std::invalid_argument("render::Queue: unsupported index type");
+  }
+  Push(program, vertex_array, mode, type, static_cast<std::intptr_t>(offset), count, uniforms);
+}
+
+void Queue::Push(
+  shader::Program &program,
+  const GLuint vertex_array,
+  const GLenum mode,
+  const GLenum type,
+  const std::intptr_t start,
+  const GLsizei count,
+  const UniformSet uniforms
+) {
+  if (mode > GL_TRIANGLE_STRIP_ADJACENCY) {
+    throw std::invalid_argument("render::Queue: unsupported primitive mode");
+  }
+  if (uniforms > uniform_sets_.size()) {
+    throw std::out_of_range("render::Queue: unknown uniform set");
+  }
+  if (packets_.size() == kMaxPackets) {
+    throw std::length_error("render::Queue: too many draws before Submit");
+  }
+  const std::uint64_t type_bits = IndexTypeBits(type);
+  const std::uint64_t program_slot = Slot(program_slots_, programs_, &program, kMaxPrograms);
+  const std::uint64_t vertex_array_slot = Slot(vertex_array_slots_, vertex_arrays_, vertex_array, kMaxVertexArrays);
+
+  keys_.push_back(
+    program_slot << kProgramShift
+    | vertex_array_slot << kVertexArrayShift
+    | std::uint64_t(uniforms) << kUniformsShift
+    | type_bits << kTypeShift
+    | std::uint64_t(mode) << kModeShift
+    | packets_.size()
+  );
+  packets_.push_back({start, count});
+}
+
+void Queue::Sort() {
+  // Least significant digit first, over the state bits only. Keys are pushed
+  // in packet order and every pass is stable, so equal state keeps it
+  std::array<std::array<std::uint32_t, 1 << kRadixBits>, kRadixPasses> histograms{};
+  for (const std::uint64_t key : keys_) {
+    for (int pass = 0; pass < kRadixPasses; ++pass) {
+      ++histograms[pass][Field(key, kPacketBits + pass * kRadixBits, kRadixBits)];
+    }
+  }
+
+  scratch_.resize(keys_.size());
+  for (int pass = 0; pass < kRadixPasses; ++pass) {
+    const int shift = kPacketBits + pass * kRadixBits;
+    auto &histogram = histograms[pass];
+    // Every key has the same digit, nothing would move
+    if (histogram[Field(keys_.front(), shift, kRadixBits)] == keys_.size()) {
+      continue;
+    }
+    std::uint32_t offset = 0;
+    for (std::uint32_t &count : histogram) {
+      offset += std::exchange(count, offset);
+    }
+    for (const std::uint64_t key : keys_) {
+      scratch_[histogram[Field(key, shift, kRadixBits)]++] = key;
+    }
+    keys_.swap(scratch_);
+  }
+}
+
+void Queue::Submit() {
+  if (!keys_.empty()) {
+    Sort();
+  }
+
+  gl::State &state = gl::State::Current();
+  // Uniform values stay with a program, so a set is only applied again when
+  // something else was applied to the program in between
+  applied_.assign(programs_.size(), kNoUniforms);
+  std::uint64_t current_program = ~std::uint64_t(0);
+  std::uint64_t current_vertex_array = ~std::uint64_t(0);
+
+  for (std::size_t i = 0; i < keys_.size();) {
+    const std::uint64_t draw_state = keys_[i] >> kPacketBits;
+    const std::uint64_t program = Field(keys_[i], kProgramShift, 12);
+    const std::uint64_t vertex_array = Field(keys_[i], kVertexArrayShift, 12);
+    const auto uniforms = static_cast<UniformSet>(Field(keys_[i], kUniformsShift, 14));
+    const GLenum type = kIndexTypes[Field(keys_[i], kTypeShift, 2)];
+    const auto mode = static_cast<GLenum>(Field(keys_[i], kModeShift, 4));
+
+    if (program != current_program) {
+      programs_[program]->use();
+      current_program = program;
+      ++statistics_.program_changes;
+    }
+    if (vertex_array != current_vertex_array) {
+      state.BindVertexArray(vertex_arrays_[vertex_array]);
+      current_vertex_array = vertex_array;
+      ++statistics_.vertex_array_changes;
+    }
+    if (uniforms != kNoUniforms && applied_[program] != uniforms) {
+      const Range range = uniform_sets_[uniforms - 1];
+      for (std::uint32_t value = range.begin; value < range.end; ++value) {
+        uniform_values_[value].Apply(*programs_[program]);
+      }
+      applied_[program] = uniforms;
+      ++statistics_.uniform_changes;
+    }
+
+    // Gathers the run of packets sharing this state. Ranges that continue
+    // the previous one are drawn as part of it where the mode allows
+    const GLsizei list_vertices = ListVertices(mode);
+    const std::intptr_t unit = type == GL_NONE ? 1 : static_cast<std::intptr_t>(IndexSize(type));
+    for (; i < keys_.size() && keys_[i] >> kPacketBits == draw_state; ++i) {
+      const Packet &packet = packets_[Field(keys_[i], 0, kPacketBits)];
+      ++statistics_.packets;
+      if (packet.count <= 0) {
+        continue;
+      }
+      if (!counts_.empty() && list_vertices && counts_.back() % list_vertices == 0) {
+        const std::intptr_t end = type == GL_NONE
+                                    ? firsts_.back() + counts_.back()
+                                    : reinterpret_cast<std::intptr_t>(offsets_.back()) + counts_.back() * unit;
+        if (packet.start == end) {
+          counts_.back() += packet.count;
+          continue;
+        }
+      }
+      if (type == GL_NONE) {
+        firsts_.push_back(static_cast<GLint>(packet.start));
+      } else {
+        offsets_.push_back(reinterpret_cast<const void *>(packet.start));
+      }
+      counts_.push_back(packet.count);
+    }
+    Draw(mode, type);
+  }
+
+  keys_.clear();
+  packets_.clear();
+  programs_.clear();
+  program_slots_.clear();
+  vertex_arrays_.clear();
+  vertex_array_slots_.clear();
+  uniform_values_.clear();
+  uniform_sets_.clear();
+  uniform_set_hashes_.clear();
+}
+
+void Queue::Draw(const GLenum mode, const GLenum type) {
+  if (counts_.empty()) {
+    return;
+  }
+  const auto draws = static_cast<GLsizei>(counts_.size());
+  if (type == GL_NONE) {
+    if (draws == 1) {
+      glDrawArrays(mode, firsts_.front(), counts_.front());
+    } else {
+      glMultiDrawArrays(mode, firsts_.data(), counts_.data(), draws);
+    }
+  } else {
+    if (draws == 1) {
+      glDrawElements(mode, counts_.front(), type, offsets_.front());
+    } else {
+      glMultiDrawElements(mode, counts_.data(), type, offsets_.data(), draws);
+    }
+  }
+  ++statistics_.draw_calls;
+  firsts_.clear();
+  counts_.clear();
+  offsets_.clear();
+}
+}
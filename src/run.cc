@@ -3,8 +3,25 @@
 //
 #include "embers/run.h"
 
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <optional>
 #include <ranges>
-#include <bits/ranges_algo.h>
+#include <utility>
+#include <vector>
+
+#include "embers/compiler.h"
+#include "embers/frame_scheduler.h"
+#include "embers/gl_handle.h"
+#include "embers/gl_state.h"
+#include "embers/profiler.h"
+#include "embers/program_cache.h"
+#include "embers/render_queue.h"
+#include "embers/shader_library.h"
+#include "embers/shader_watcher.h"
+#include "embers/uniform_buffer.h"
+#include "embers/vertex.h"
 
 void processInput(GLFWwindow *window) {
   if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
@@ -13,6 +30,7 @@ void processInput(GLFWwindow *window) {
 
 int run() {
   using namespace embers;
+  using namespace embers::shader::literals;
 
   const int height = 900;
   const int width = 2300;
@@ -35,8 +53,14 @@ int run() {
     }
   }
 
-  glViewport(0, 0, width, height);
-  glClearColor(.2f, .3f, .3f, 1.f);
+  // Opt-in profiling, e.g. EMBERS_PROFILE=trace.json, written on exit
+  const char *trace_path = std::getenv("EMBERS_PROFILE");
+  profile::Profiler &profiler = profile::Profiler::Global();
+  profiler.Enable(trace_path != nullptr);
+
+  gl::State &state = gl::State::Current();
+  state.Viewport(0, 0, width, height);
+  state.ClearColor(.2f, .3f, .3f, 1.f);
 
   const char *vertex_shader_source =
     "#version 330 core\n"
@@ -48,51 +72,105 @@ int run() {
     "vertexColor = vec4(aColor, 1.0);"
     "}\0";
 
-  const std::vector fragment_shader_sources =
-  {
+  // Both triangles use this shader, built in the variants below
+  const char *fragment_shader_source =
     "#version 330 core\n"
     "out vec4 FragColor;\n"
     "in vec4 vertexColor;\n"
-    "uniform float ourColor;\n"
-    "void main() {\n"
-    "FragColor = vertexColor / ourColor; \n"
-    "}\0",
-
-    "#version 330 core\n"
-    "out vec4 FragColor;\n"
-    "in vec4 vertexColor;\n"
-    "uniform float ourColor;\n"
+    "layout(std140) uniform Frame {\n"
+    "  float ourColor;\n"
+    "};\n"
+    "#ifdef PIXEL_CENTER_INTEGER\n"
     "layout(pixel_center_integer) in vec4 gl_FragCoord;\n"
+    "#endif\n"
     "void main() {\n"
-    "FragColor = vertexColor / (ourColor * 2.0); \n"
-    "}\0"
+    "FragColor = vertexColor / (ourColor * SCALE); \n"
+    "}\0";
+
+  const std::vector<std::vector<std::string_view>> fragment_shader_defines =
+  {
+    {"SCALE=1.0"},
+    {"SCALE=2.0", "PIXEL_CENTER_INTEGER"},
   };
+
+  // Opt-in shader reloading, e.g. EMBERS_SHADER_DIR=shaders. The shaders are
+  // read from there, written with the text above if missing, and programs
+  // are rebuilt between frames when they are edited
+  const char *shader_directory = std::getenv("EMBERS_SHADER_DIR");
+  shader::Library shader_library(shader_directory ? shader_directory : "");
+  if (shader_directory) {
+    const std::filesystem::path directory(shader_directory);
+    std::filesystem::create_directories(directory);
+    for (const auto &[name, text] : {
+           std::pair{"triangle.vert", vertex_shader_source},
+           std::pair{"triangle.frag", fragment_shader_source}
+         }) {
+      if (!std::filesystem::exists(directory / name)) {
+        std::ofstream(directory / name) << text;
+      }
+    }
+  } else {
+    shader_library.Add("triangle.vert", vertex_shader_source);
+    shader_library.Add("triangle.frag", fragment_shader_source);
+  }
+
   constexpr int x = 2;
 
-  shader::Program programs[x];
+  // Opt-in program binary cache, e.g. EMBERS_PROGRAM_CACHE=~/.cache/embers
+  std::optional<shader::ProgramCache> program_cache;
+  if (const char *directory = std::getenv("EMBERS_PROGRAM_CACHE")) {
+    program_cache.emplace(directory);
+  }
+
+  // Without parallel compile in the driver, compile on a hidden window that
+  // shares objects with the main one
+  GLFWwindow *compile_window = nullptr;
+  shader::SharedContext compile_context{
+    [&compile_window] { glfwMakeContextCurrent(compile_window); },
+    [] { glfwMakeContextCurrent(nullptr); }
+  };
+  if (!shader::Compiler::DriverCompilesInParallel()) {
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    compile_window = glfwCreateWindow(1, 1, "", nullptr, window);
+  }
+
+  // Programs are only submitted here and resolved once the geometry is set up
+  const auto compile_start = std::chrono::steady_clock::now();
+  std::optional<shader::Compiler> compiler(std::in_place, compile_window ? &compile_context : nullptr);
+  std::vector<shader::ProgramFuture> pending_programs;
   {
-    auto vertex_shader = shader::Source(vertex_shader_source, shader::Type::kVertex).Compile();
+    const auto vertex_source = shader_library.Load("triangle.vert", shader::Type::kVertex);
 
     for (int i = 0; i < x; ++i) {
-      auto fragment_shader = shader::Source(fragment_shader_sources[i], shader::Type::kFragment).Compile();
-
-      programs[i] = shader::Program::Builder()
-      .AttachShader(vertex_shader)
-      .AttachShader(fragment_shader)
-      .Link();
+      const auto fragment_source = shader_library.Load(
+                                                       "triangle.frag",
+                                                       shader::Type::kFragment,
+                                                       fragment_shader_defines[i]
+                                                      );
+      pending_programs.push_back(
+                                 compiler->Build(
+                                                 {vertex_source, fragment_source},
+                                                 program_cache ? &*program_cache : nullptr
+                                                )
+                                );
     }
   }
 
-  constexpr float vertices[x][3 * 5] = {
+  struct Vertex {
+    vertex::Vec<GLfloat, 2> position;
+    vertex::Vec<GLubyte, 3, true> color;
+  };
+
+  constexpr Vertex vertices[x][3] = {
     {
-      -0.5f, 0.7f, 1.0f, 0.0f, 0.0f,
-      0.7f, 0.7f, 0.0f, 1.0f, 0.0f,
-      0.7f, -0.7f, 0.0f, 0.0f, 1.0f
+      {{-0.5f, 0.7f}, {255, 0, 0}},
+      {{0.7f, 0.7f}, {0, 255, 0}},
+      {{0.7f, -0.7f}, {0, 0, 255}}
     },
     {
-      -0.7f, 0.7f, 1.0f, 1.0f, 0.0f,
-      0.5f, -0.7f, 1.0f, 0.0f, 1.0f,
-      -0.7f, -0.7f, 0.0f, 1.0f, 1.0f
+      {{-0.7f, 0.7f}, {255, 255, 0}},
+      {{0.5f, -0.7f}, {255, 0, 255}},
+      {{-0.7f, -0.7f}, {0, 255, 255}}
     }
   };
 
@@ -102,58 +180,122 @@ int run() {
   };
 
   //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-  unsigned int element_buffer_object;
-  glGenBuffers(1, &element_buffer_object);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, element_buffer_object);
+  const gl::Buffer element_buffer_object = gl::Buffer::Create();
+  state.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, element_buffer_object.get());
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 
   //glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-  unsigned int vertex_array_object[x];
-  unsigned int vertex_buffer_object[x];
-
-  glGenVertexArrays(x, vertex_array_object);
-  glGenBuffers(x, vertex_buffer_object);
+  gl::VertexArray vertex_array_object[x];
+  gl::Buffer vertex_buffer_object[x];
 
   for (int i = 0; i < x; ++i) {
-    glBindVertexArray(vertex_array_object[i]);
-    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_object[i]);
+    vertex_array_object[i] = gl::VertexArray::Create();
+    vertex_buffer_object[i] = gl::Buffer::Create();
+    state.BindVertexArray(vertex_array_object[i].get());
+    state.BindBuffer(GL_ARRAY_BUFFER, vertex_buffer_object[i].get());
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices[i]), vertices[i], GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*) 0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*) (2 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    vertex::SetAttributes<Vertex>(0, vertex_buffer_object[i].get());
   }
 
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  glBindVertexArray(0);
+  state.BindBuffer(GL_ARRAY_BUFFER, 0);
+  state.BindVertexArray(0);
+
+  shader::Program programs[x];
+  {
+    for (int i = 0; i < x; ++i) {
+      programs[i] = pending_programs[i].Get();
+    }
+    pending_programs.clear();
+    compiler.reset();
+    if (compile_window) {
+      glfwDestroyWindow(compile_window);
+    }
+
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - compile_start;
+    std::cout << "Built " << x << " programs in " << elapsed.count() << " ms" << std::endl;
+    if (program_cache) {
+      program_cache->Report(std::cout);
+    }
+  }
+
+  std::optional<shader::Watcher> shader_watcher;
+  if (shader_directory) {
+    shader_watcher.emplace(shader_library);
+    for (int i = 0; i < x; ++i) {
+      shader_watcher->Watch(
+        programs[i],
+        {
+          {"triangle.vert", shader::Type::kVertex, {}},
+          {
+            "triangle.frag",
+            shader::Type::kFragment,
+            {fragment_shader_defines[i].begin(), fragment_shader_defines[i].end()}
+          }
+        }
+      );
+    }
+  }
+
+  // Shared by both programs and uploaded once per frame
+  struct FrameUniforms {
+    GLfloat our_color;
+  };
+  gl::UniformBuffer<FrameUniforms> frame_uniforms(0);
+  for (int i = 0; i < x; ++i) {
+    frame_uniforms.Attach(programs[i], "Frame"_uniform);
+  }
 
   const int max_fps = 30;
-  const double seconds_per_frame = 1.0 / max_fps;
+  FrameScheduler scheduler(max_fps);
+  // Only vsync-driven pacing should have buffer swaps wait for the display
+  glfwSwapInterval(scheduler.mode() == FrameScheduler::Mode::kVsync ? 1 : 0);
 
-  double t1 = glfwGetTime(), t2;
+  render::Queue render_queue;
   while (!glfwWindowShouldClose(window)) {
-    auto t2 = t1;
-    t1 = glfwGetTime();
-    auto sleep_duration = std::chrono::duration<double>(seconds_per_frame + t2 - t1);
-    std::this_thread::sleep_for(sleep_duration);
+    {
+      profile::CpuZone zone("Wait");
+      scheduler.WaitForNextFrame();
+    }
 
-    processInput(window);
-    glClear(GL_COLOR_BUFFER_BIT);
-    for (int i = 0; i < x; ++i) {
-      programs[i]
-        .use()
-        .setUniform(
-                    "ourColor",
-                    static_cast<GLfloat>((sin(glfwGetTime()) + 1) / 2)
-                   );
-      glBindVertexArray(vertex_array_object[i]);
-      glDrawArrays(GL_TRIANGLES, 0, 3);
+    {
+      // Work, apart from the time spent waiting above and for the swap below
+      profile::CpuZone zone("Frame");
+      profile::GpuZone gpu_zone("Frame");
+      processInput(window);
+      glClear(GL_COLOR_BUFFER_BIT);
+      frame_uniforms.data().our_color = static_cast<GLfloat>((sin(glfwGetTime()) + 1) / 2);
+      frame_uniforms.Upload();
+      for (int i = 0; i < x; ++i) {
+        render_queue.DrawArrays(programs[i], vertex_array_object[i].get(), GL_TRIANGLES, 0, 3);
+      }
+      render_queue.Submit();
     }
 
-    glfwSwapBuffers(window);
+    {
+      profile::CpuZone zone("Swap");
+      glfwSwapBuffers(window);
+    }
     glfwPollEvents();
+    if (shader_watcher) {
+      profile::CpuZone zone("Reload");
+      shader_watcher->Poll();
+    }
+    profiler.EndFrame();
+    // Objects given back this frame are deleted now that nothing uses them
+    gl::Collect();
   }
 
+  scheduler.Report(std::cout);
+  std::cout << "render queue: " << render_queue.statistics().packets << " draws in "
+    << render_queue.statistics().draw_calls << " calls" << std::endl;
+  std::cout << "state cache: " << state.statistics().hits << " calls skipped, "
+    << state.statistics().misses << " made" << std::endl;
+  if (trace_path) {
+    profiler.Report(std::cout);
+    std::ofstream trace(trace_path);
+    profiler.WriteTrace(trace);
+    profiler.Reset();
+  }
   return 0;
 }
@@ -5,9 +5,16 @@
 #include "embers/shader.h"
 
 #include <algorithm>
+#include <chrono>
 #include <istream>
+#include <iterator>
 #include <memory>
 #include <cstring>
+#include <system_error>
+
+#include "embers/gl_state.h"
+#include "embers/profiler.h"
+#include "embers/program_cache.h"
 
 namespace embers::shader {
 // ShaderException
@@ -18,14 +25,16 @@ const char *ShaderException::what() const noexcept { return std::runtime_error::
 
 // Source
 
+Source::Source(const Type type) : type_(type) {}
+
 Source::Source(const char *source, const Type type, const size_t length)
-  : source_(new char[length ? length + 1 : strlen(source)])
+  : source_(new char[(length ? length : strlen(source)) + 1])
 , type_(type) {
-  // I don't like I have to copy the array, but I don't see a way to transfer
-  // ownership to the class since `source` *can be* static and at the same time
-  // can live shorter than Source
-  std::copy_n(source, length ? length + 1 : strlen(source), source_.get());
-  source_[(length ? length + 1 : strlen(source))] = '\0';
+  // Borrow or Map avoid this copy when the text is known to outlive Source
+  const size_t size = length ? length : strlen(source);
+  std::copy_n(source, size, source_.get());
+  source_[size] = '\0';
+  Append({source_.get(), size});
 }
 
 Source::Source(std::istream &input_stream, const Type type, const size_t length)
@@ -33,16 +42,48 @@ Source::Source(std::istream &input_stream, const Type type, const size_t length)
 , type_(type) {
   if (length) {
     input_stream.read(source_.get(), length);
-    source_[length] = '\0';
-    return;
+    source_[input_stream.gcount()] = '\0';
+  }
+  Append(source_.get());
+}
+
+Source Source::Borrow(const std::string_view source, const Type type) {
+  Source result(type);
+  result.Append(source);
+  return result;
+}
+
+Source Source::Borrow(const std::span<const std::string_view> fragments, const Type type) {
+  Source result(type);
+  result.strings_.reserve(fragments.size());
+  result.lengths_.reserve(fragments.size());
+  for (const std::string_view fragment : fragments) {
+    result.Append(fragment);
+  }
+  return result;
+}
+
+Source Source::Map(const std::filesystem::path &path, const Type type) {
+  Source result(type);
+  try {
+    result.mapping_ = MappedFile(path);
+  } catch (const std::system_error &error) {
+    throw ShaderException(error.what());
   }
+  result.Append(result.mapping_.view());
+  return result;
+}
+
+void Source::Append(const std::string_view fragment) {
+  strings_.push_back(fragment.data());
+  lengths_.push_back(static_cast<GLint>(fragment.size()));
 }
 
 Shader Source::Compile() const {
+  profile::CpuZone zone("Source::Compile");
   GLint success = GL_FALSE;
   GLuint shader = glCreateShader(type_);
-  const char *const sources = source_.get();
-  glShaderSource(shader, 1, &sources, nullptr);
+  Upload(shader);
   glCompileShader(shader);
   glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
   if (success != GL_FALSE) {
@@ -56,95 +97,357 @@ Shader Source::Compile() const {
   throw ShaderException(error_log.get());
 }
 
-std::unique_ptr<char[]> Source::ReadAllFromStream(std::istream &input_stream) {
-  std::string s(std::istreambuf_iterator<char>(input_stream), {});
-  return std::unique_ptr<char[]>(s.data());
+void Source::Upload(const GLuint shader) const {
+  glShaderSource(shader, static_cast<GLsizei>(strings_.size()), strings_.data(), lengths_.data());
 }
 
-// Shader
-Shader::Shader(GLuint shader) : shader_(shader) {}
+std::string Source::Join() const {
+  std::string text;
+  for (std::size_t i = 0; i < fragment_count(); ++i) {
+    text += fragment(i);
+  }
+  return text;
+}
 
-Shader::~Shader() {
-  glDeleteShader(shader_);
+std::unique_ptr<char[]> Source::ReadAllFromStream(std::istream &input_stream) {
+  // Seekable streams are read in one go straight into the buffer
+  const auto start = input_stream.tellg();
+  if (start != std::istream::pos_type(-1) && input_stream.seekg(0, std::ios::end)) {
+    const auto size = static_cast<size_t>(input_stream.tellg() - start);
+    input_stream.seekg(start);
+    auto source = std::make_unique<char[]>(size + 1);
+    input_stream.read(source.get(), static_cast<std::streamsize>(size));
+    source[input_stream.gcount()] = '\0';
+    return source;
+  }
+  input_stream.clear();
+  const std::string s(std::istreambuf_iterator<char>(input_stream), {});
+  auto source = std::make_unique<char[]>(s.size() + 1);
+  std::copy_n(s.c_str(), s.size() + 1, source.get());
+  return source;
 }
 
+// Shader
+Shader::Shader(const GLuint shader) : shader_(gl::Handle<gl::Kind::kShader>::Adopt(shader)) {}
+
 // Program Builder
-Program::Builder::Builder() {
-  program_ = glCreateProgram();
-}
+Program::Builder::Builder() : program_(gl::Handle<gl::Kind::kProgram>::Adopt(glCreateProgram())) {}
 
 Program::Builder &Program::Builder::AttachShader(Shader &shader) {
-  glAttachShader(program_, static_cast<GLuint>(shader));
-  attached_shaders_.insert(static_cast<GLuint>(shader));
+  if (attached_shader_count_ == kMaxAttached) {
+    throw std::length_error("Program::Builder: too many shaders attached");
+  }
+  glAttachShader(program_.get(), static_cast<GLuint>(shader));
+  attached_shaders_[attached_shader_count_++] = static_cast<GLuint>(shader);
   return *this;
 }
 
 Program::Builder &Program::Builder::DetachShader(Shader &shader) {
-  glDetachShader(program_, static_cast<GLuint>(shader));
-  attached_shaders_.erase(static_cast<GLuint>(shader));
+  glDetachShader(program_.get(), static_cast<GLuint>(shader));
+  const auto attached = std::span(attached_shaders_).first(attached_shader_count_);
+  const auto found = std::ranges::find(attached, static_cast<GLuint>(shader));
+  if (found != attached.end()) {
+    std::shift_left(found, attached.end(), 1);
+    --attached_shader_count_;
+  }
+  return *this;
+}
+
+Program::Builder &Program::Builder::AttachSource(const Source &source) {
+  if (attached_source_count_ == kMaxAttached) {
+    throw std::length_error("Program::Builder: too many sources attached");
+  }
+  attached_sources_[attached_source_count_++] = &source;
+  return *this;
+}
+
+Program::Builder &Program::Builder::UseCache(ProgramCache &cache) {
+  cache_ = &cache;
   return *this;
 }
 
 Program Program::Builder::Link() {
-  glLinkProgram(program_);
+  profile::CpuZone zone("Program::Builder::Link");
+  const auto start = std::chrono::steady_clock::now();
+  const GLuint name = program_.get();
+  const auto sources = std::span(attached_sources_).first(attached_source_count_);
+  const bool cached = cache_ && cache_->IsSupported() && attached_shader_count_ == 0 && !sources.empty();
+  const std::uint64_t key = cached ? cache_->Key(sources) : 0;
+  if (cached && cache_->Load(name, key)) {
+    // Reflection may throw, in which case the builder still owns the program
+    Program program(static_cast<GLint>(name));
+    program_.Release();
+    cache_->Record(true, std::chrono::steady_clock::now() - start);
+    return program;
+  }
+
+  std::array<Shader, kMaxAttached> compiled;
+  for (std::size_t i = 0; i < sources.size(); ++i) {
+    compiled[i] = sources[i]->Compile();
+    glAttachShader(name, static_cast<GLuint>(compiled[i]));
+  }
+  if (cached) {
+    glProgramParameteri(name, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
+  glLinkProgram(name);
+  // The linked executable does not need its shaders attached anymore
+  for (std::size_t i = 0; i < sources.size(); ++i) {
+    glDetachShader(name, static_cast<GLuint>(compiled[i]));
+  }
+  for (const GLuint shader : std::span(attached_shaders_).first(attached_shader_count_)) {
+    glDetachShader(name, shader);
+  }
+  attached_shader_count_ = 0;
+
   GLint success = 0;
-  glGetProgramiv(program_, GL_LINK_STATUS, &success);
+  glGetProgramiv(name, GL_LINK_STATUS, &success);
   if (success != GL_FALSE) {
-    is_built_ = true;
-    return Program(program_);
+    Program program(static_cast<GLint>(name));
+    program_.Release();
+    if (cached) {
+      cache_->Store(name, key);
+      cache_->Record(false, std::chrono::steady_clock::now() - start);
+    }
+    return program;
   }
   GLint log_size = 0;
-  glGetProgramiv(program_, GL_INFO_LOG_LENGTH, &log_size);
+  glGetProgramiv(name, GL_INFO_LOG_LENGTH, &log_size);
   auto error_log = std::make_unique<char[]>(log_size);
-  glGetProgramInfoLog(program_, log_size, &log_size, error_log.get());
+  glGetProgramInfoLog(name, log_size, &log_size, error_log.get());
   throw ShaderException(error_log.get());
 }
 
-Program::Builder::~Builder() {
-  if (!is_built_) {
-    glDeleteProgram(program_);
+// Program
+// Owns the program only once reflection succeeded, so a throw leaves it to
+// the caller
+Program::Program(GLint program)
+  : uniforms_(program ? ReflectUniforms(program) : std::vector<UniformInfo>())
+, uniform_blocks_(program ? ReflectUniformBlocks(program) : std::vector<UniformBlockInfo>()) {
+  program_ = gl::Handle<gl::Kind::kProgram>::Adopt(static_cast<GLuint>(program));
+}
+
+std::vector<Program::UniformInfo> Program::ReflectUniforms(const GLint program) {
+  GLint count = 0;
+  GLint max_name_length = 0;
+  glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+  glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_name_length);
+
+  std::vector<UniformInfo> uniforms;
+  uniforms.reserve(count);
+  auto name = std::make_unique<char[]>(max_name_length + 1);
+  for (GLint i = 0; i < count; ++i) {
+    GLsizei length = 0;
+    GLint size = 0;
+    GLenum type = 0;
+    glGetActiveUniform(program, i, max_name_length + 1, &length, &size, &type, name.get());
+    const GLint location = glGetUniformLocation(program, name.get());
+    // Members of uniform blocks have no location of their own
+    if (location < 0) {
+      continue;
+    }
+    // Arrays are reported as "name[0]", but are looked up by their bare name
+    std::string_view view(name.get(), length);
+    if (view.ends_with("[0]")) {
+      view.remove_suffix(3);
+    }
+    const std::uint64_t hash = Fnv1a(view);
+    if (std::ranges::any_of(uniforms, [hash](const UniformInfo &info) { return info.hash == hash; })) {
+      throw ShaderException("Uniform name hash collision");
+    }
+    uniforms.push_back({hash, location, type, size});
+  }
+  return uniforms;
+}
+
+std::vector<Program::UniformBlockInfo> Program::ReflectUniformBlocks(const GLint program) {
+  GLint count = 0;
+  GLint max_name_length = 0;
+  glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+  glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &max_name_length);
+
+  std::vector<UniformBlockInfo> blocks;
+  blocks.reserve(count);
+  auto name = std::make_unique<char[]>(max_name_length + 1);
+  for (GLint i = 0; i < count; ++i) {
+    const auto index = static_cast<GLuint>(i);
+    GLsizei length = 0;
+    GLint size = 0;
+    glGetActiveUniformBlockName(program, index, max_name_length + 1, &length, name.get());
+    glGetActiveUniformBlockiv(program, index, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+    const std::uint64_t hash = Fnv1a(std::string_view(name.get(), length));
+    if (std::ranges::any_of(blocks, [hash](const UniformBlockInfo &info) { return info.hash == hash; })) {
+      throw ShaderException("Uniform block name hash collision");
+    }
+    blocks.push_back({hash, index, size, -1});
   }
-  for (auto shader : attached_shaders_) {
-    glDetachShader(program_, shader);
+  return blocks;
+}
+
+std::uint32_t Program::FindUniform(const UniformName name, bool (*accepts)(GLenum type)) const {
+  for (std::uint32_t i = 0; i < uniforms_.size(); ++i) {
+    if (uniforms_[i].hash != name.hash() || uniforms_[i].retired) {
+      continue;
+    }
+    if (!accepts(uniforms_[i].type)) {
+      throw ShaderException("Uniform type does not match the value type");
+    }
+    return i;
   }
+  throw ShaderException("No active uniform with this name");
 }
 
-// Program
-Program::Program(GLint program) : program_(program) {}
+GLint Program::UniformLocation(const std::uint32_t index) const {
+  if (index >= uniforms_.size()) {
+    throw ShaderException("Uniform handle does not belong to this program");
+  }
+  return uniforms_[index].location;
+}
 
-Program::Program(Program &&program) noexcept : program_(program.program_) {
-  program.program_ = 0;
+// Set with glUniform1i, which GL refuses for uint uniforms
+bool Program::AcceptsBoolean(const GLenum type) {
+  return type == GL_BOOL || type == GL_INT;
 }
 
+bool Program::AcceptsInt(const GLenum type) {
+  switch (type) {
+    case GL_INT:
+    case GL_BOOL:
+    case GL_SAMPLER_1D:
+    case GL_SAMPLER_2D:
+    case GL_SAMPLER_3D:
+    case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_1D_SHADOW:
+    case GL_SAMPLER_2D_SHADOW:
+    case GL_SAMPLER_1D_ARRAY:
+    case GL_SAMPLER_2D_ARRAY:
+    case GL_SAMPLER_1D_ARRAY_SHADOW:
+    case GL_SAMPLER_2D_ARRAY_SHADOW:
+    case GL_SAMPLER_2D_MULTISAMPLE:
+    case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_SAMPLER_CUBE_SHADOW:
+    case GL_SAMPLER_BUFFER:
+    case GL_SAMPLER_2D_RECT:
+    case GL_SAMPLER_2D_RECT_SHADOW:
+    case GL_INT_SAMPLER_1D:
+    case GL_INT_SAMPLER_2D:
+    case GL_INT_SAMPLER_3D:
+    case GL_INT_SAMPLER_CUBE:
+    case GL_INT_SAMPLER_1D_ARRAY:
+    case GL_INT_SAMPLER_2D_ARRAY:
+    case GL_INT_SAMPLER_2D_MULTISAMPLE:
+    case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_INT_SAMPLER_BUFFER:
+    case GL_INT_SAMPLER_2D_RECT:
+    case GL_UNSIGNED_INT_SAMPLER_1D:
+    case GL_UNSIGNED_INT_SAMPLER_2D:
+    case GL_UNSIGNED_INT_SAMPLER_3D:
+    case GL_UNSIGNED_INT_SAMPLER_CUBE:
+    case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE:
+    case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+    case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
+      return true;
+    default:
+      return false;
+  }
+}
 
-Program::~Program() {
-  glDeleteProgram(program_);
+bool Program::AcceptsFloat(const GLenum type) {
+  return type == GL_FLOAT;
 }
 
+
 Program &Program::use() {
-  glUseProgram(static_cast<GLuint>(program_));
+  gl::State::Current().UseProgram(program_.get());
   return *this;
 }
 
-Program &Program::setUniform(const char *name, GLboolean value) {
-  glUniform1i(glGetUniformLocation(program_, name), static_cast<GLint>(value));
+Program &Program::Reload(Program &&program) {
+  // Keep every known uniform at its index, so existing handles still match.
+  // One that comes back with its old type is live again
+  std::vector<UniformInfo> uniforms = uniforms_;
+  for (UniformInfo &uniform : uniforms) {
+    const auto replacement = std::ranges::find(program.uniforms_, uniform.hash, &UniformInfo::hash);
+    if (replacement == program.uniforms_.end() || replacement->type != uniform.type) {
+      uniform.location = -1;
+      uniform.retired = true;
+      continue;
+    }
+    uniform = *replacement;
+  }
+  // A uniform that changed type gets a new entry next to the retired one
+  for (const UniformInfo &uniform : program.uniforms_) {
+    const auto same = [&uniform](const UniformInfo &known) {
+      return known.hash == uniform.hash && known.type == uniform.type;
+    };
+    if (std::ranges::none_of(uniforms, same)) {
+      uniforms.push_back(uniform);
+    }
+  }
+
+  // Blocks keep their binding points; the new program starts without any
+  for (UniformBlockInfo &block : program.uniform_blocks_) {
+    const auto previous = std::ranges::find(uniform_blocks_, block.hash, &UniformBlockInfo::hash);
+    if (previous != uniform_blocks_.end() && previous->binding >= 0) {
+      block.binding = previous->binding;
+      glUniformBlockBinding(program.program_.get(), block.index, static_cast<GLuint>(block.binding));
+    }
+  }
+
+  program_ = std::move(program.program_);
+  uniforms_ = std::move(uniforms);
+  uniform_blocks_ = std::move(program.uniform_blocks_);
+  program.uniforms_.clear();
+  program.uniform_blocks_.clear();
   return *this;
 }
 
-Program &Program::setUniform(const char *name, GLint value) {
-  glUniform1i(glGetUniformLocation(program_, name), value);
+Program &Program::BindUniformBlock(const UniformName name, const GLuint binding, const GLsizeiptr size) {
+  const auto block = std::ranges::find(uniform_blocks_, name.hash(), &UniformBlockInfo::hash);
+  if (block == uniform_blocks_.end()) {
+    throw ShaderException("No active uniform block with this name");
+  }
+  if (size && block->size > size) {
+    throw ShaderException("Uniform block is larger than its buffer");
+  }
+  if (block->binding != static_cast<GLint>(binding)) {
+    glUniformBlockBinding(program_.get(), block->index, binding);
+    block->binding = static_cast<GLint>(binding);
+  }
   return *this;
 }
 
-Program &Program::setUniform(const char *name, GLfloat value) {
-  glUniform1f(glGetUniformLocation(program_, name), value);
+bool Program::HasUniformBlock(const UniformName name) const {
+  return std::ranges::find(uniform_blocks_, name.hash(), &UniformBlockInfo::hash) != uniform_blocks_.end();
+}
+
+Program &Program::setUniform(const Uniform<GLboolean> uniform, const GLboolean value) {
+  glUniform1i(UniformLocation(uniform.index_), static_cast<GLint>(value));
+  return *this;
+}
+
+Program &Program::setUniform(const Uniform<GLint> uniform, const GLint value) {
+  glUniform1i(UniformLocation(uniform.index_), value);
   return *this;
 }
 
-Program &Program::operator=(Program &&program) noexcept {
-  program_ = program.program_;
-  program.program_ = 0;
+Program &Program::setUniform(const Uniform<GLfloat> uniform, const GLfloat value) {
+  glUniform1f(UniformLocation(uniform.index_), value);
   return *this;
 }
 
+Program &Program::setUniform(const char *name, GLboolean value) {
+  return setUniform(uniform<GLboolean>(UniformName(name)), value);
+}
+
+Program &Program::setUniform(const char *name, GLint value) {
+  return setUniform(uniform<GLint>(UniformName(name)), value);
+}
+
+Program &Program::setUniform(const char *name, GLfloat value) {
+  return setUniform(uniform<GLfloat>(UniformName(name)), value);
+}
+
 }
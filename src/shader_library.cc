@@ -0,0 +1,228 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/shader_library.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+namespace embers::shader {
+namespace {
+constexpr std::string_view kWhitespace = " \t\r";
+
+// Files are known by their normalized path, so every spelling of a name,
+// e.g. "./common.glsl", reaches the same file
+std::string Normalize(const std::string_view name) {
+  return std::filesystem::path(name).lexically_normal().generic_string();
+}
+
+std::string_view TrimFront(std::string_view text) {
+  text.remove_prefix(std::min(text.find_first_not_of(kWhitespace), text.size()));
+  return text;
+}
+
+// Returns the name in a `#include "name"` line, or an empty view
+std::string_view IncludedName(std::string_view line) {
+  line = TrimFront(line);
+  if (!line.starts_with('#')) {
+    return {};
+  }
+  line = TrimFront(line.substr(1));
+  if (!line.starts_with("include")) {
+    return {};
+  }
+  line = TrimFront(line.substr(7));
+  if (!line.starts_with('"')) {
+    return {};
+  }
+  const size_t end = line.find('"', 1);
+  if (end == std::string_view::npos) {
+    return {};
+  }
+  return line.substr(1, end - 1);
+}
+
+// Length of the leading `#version` line including its newline, or 0
+size_t VersionLineLength(const std::string_view text) {
+  const size_t start = text.find_first_not_of(" \t\r\n");
+  if (start == std::string_view::npos || !text.substr(start).starts_with("#version")) {
+    return 0;
+  }
+  const size_t end = text.find('\n', start);
+  return end == std::string_view::npos ? text.size() : end + 1;
+}
+}
+
+Library::Library(std::filesystem::path root) : root_(std::move(root)) {}
+
+void Library::Add(const std::string &name, const std::string_view text) {
+  File &file = files_[Normalize(name)];
+  file = File();
+  file.text = text;
+}
+
+Source Library::Load(const std::string &name, const Type type, const std::span<const std::string_view> defines) {
+  const File &file = Resolve(Normalize(name));
+  std::vector<std::string_view> fragments;
+  fragments.reserve(file.fragments.size() + 2);
+
+  const std::string_view define_block = DefineBlock(defines);
+  auto fragment = file.fragments.begin();
+  if (!define_block.empty()) {
+    // `#version` has to stay the first line, so the defines go after it
+    const size_t version_length = fragment != file.fragments.end() ? VersionLineLength(*fragment) : 0;
+    if (version_length) {
+      fragments.push_back(fragment->substr(0, version_length));
+    }
+    fragments.push_back(define_block);
+    if (version_length) {
+      if (version_length < fragment->size()) {
+        fragments.push_back(fragment->substr(version_length));
+      }
+      ++fragment;
+    }
+  }
+  fragments.insert(fragments.end(), fragment, file.fragments.end());
+  return Source::Borrow(fragments, type);
+}
+
+Source Library::Load(const std::string &name, const Type type, const std::initializer_list<std::string_view> defines) {
+  return Load(name, type, std::span(defines.begin(), defines.size()));
+}
+
+void Library::Invalidate(const std::string &name) {
+  const auto found = files_.find(Normalize(name));
+  if (found == files_.end()) {
+    return;
+  }
+  File &file = found->second;
+  std::vector<std::string> includers = std::move(file.includers);
+  file.includers.clear();
+  if (file.on_disk) {
+    // Opened again by the next Load, which also sees renamed files
+    files_.erase(found);
+  } else {
+    file.resolved = false;
+  }
+  for (const std::string &includer : includers) {
+    Invalidate(includer);
+  }
+}
+
+std::vector<std::string> Library::FilesOf(const std::string &name) {
+  std::vector<std::string> files;
+  std::vector<std::string> visited;
+  std::vector<std::string> pending = {Normalize(name)};
+  while (!pending.empty()) {
+    std::string next = std::move(pending.back());
+    pending.pop_back();
+    if (std::ranges::find(visited, next) != visited.end()) {
+      continue;
+    }
+    const File &file = Resolve(next);
+    pending.insert(pending.end(), file.includes.begin(), file.includes.end());
+    if (file.on_disk) {
+      files.push_back(next);
+    }
+    visited.push_back(std::move(next));
+  }
+  return files;
+}
+
+Library::File &Library::Open(const std::string &name) {
+  if (const auto file = files_.find(name); file != files_.end()) {
+    return file->second;
+  }
+  MappedFile mapping;
+  try {
+    mapping = MappedFile(root_ / name);
+  } catch (const std::system_error &error) {
+    throw ShaderException(error.what());
+  }
+  File &file = files_[name];
+  file.mapping = std::move(mapping);
+  file.text = file.mapping.view();
+  file.on_disk = true;
+  return file;
+}
+
+Library::File &Library::Resolve(const std::string &name) {
+  File &file = Open(name);
+  if (file.resolved) {
+    return file;
+  }
+  if (file.resolving) {
+    throw ShaderException(("Include cycle through " + name).c_str());
+  }
+  // Cleared however this returns, so a file whose include failed is not
+  // taken for a cycle once the include is fixed
+  struct Resolving {
+    bool &flag;
+    ~Resolving() {
+      flag = false;
+    }
+  } resolving{file.resolving};
+  file.resolving = true;
+  file.includes.clear();
+  file.fragments.clear();
+
+  const std::string_view text = file.text;
+  size_t fragment_start = 0;
+  size_t line_start = 0;
+  while (line_start < text.size()) {
+    size_t line_end = text.find('\n', line_start);
+    line_end = line_end == std::string_view::npos ? text.size() : line_end + 1;
+    const std::string_view included = IncludedName(text.substr(line_start, line_end - line_start));
+    if (!included.empty()) {
+      if (line_start > fragment_start) {
+        file.fragments.push_back(text.substr(fragment_start, line_start - fragment_start));
+      }
+      file.includes.push_back(Normalize(included));
+      File &child = Resolve(file.includes.back());
+      if (std::ranges::find(child.includers, name) == child.includers.end()) {
+        child.includers.push_back(name);
+      }
+      file.fragments.insert(file.fragments.end(), child.fragments.begin(), child.fragments.end());
+      if (!child.fragments.empty() && !child.fragments.back().ends_with('\n')) {
+        file.fragments.emplace_back("\n");
+      }
+      fragment_start = line_end;
+    }
+    line_start = line_end;
+  }
+  if (fragment_start < text.size()) {
+    file.fragments.push_back(text.substr(fragment_start));
+  }
+
+  file.resolved = true;
+  return file;
+}
+
+std::string_view Library::DefineBlock(const std::span<const std::string_view> defines) {
+  if (defines.empty()) {
+    return {};
+  }
+  std::string key;
+  for (const std::string_view define : defines) {
+    key += define;
+    key += '\n';
+  }
+  auto [block, inserted] = define_blocks_.try_emplace(key);
+  if (inserted) {
+    for (const std::string_view define : defines) {
+      const size_t equals = define.find('=');
+      block->second += "#define ";
+      block->second += define.substr(0, equals);
+      if (equals != std::string_view::npos) {
+        block->second += ' ';
+        block->second += define.substr(equals + 1);
+      }
+      block->second += '\n';
+    }
+  }
+  return block->second;
+}
+}
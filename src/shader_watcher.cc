@@ -0,0 +1,185 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/shader_watcher.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+namespace embers::shader {
+namespace {
+std::string Normalize(const std::filesystem::path &name) {
+  return name.lexically_normal().generic_string();
+}
+
+// Files are watched through their directory, since editors often save by
+// replacing the file rather than writing to it
+constexpr std::uint32_t kEvents = IN_CLOSE_WRITE | IN_MOVED_TO;
+}
+
+Watcher::Watcher(Library &library, std::ostream &log)
+  : library_(library)
+, log_(log)
+, inotify_(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) {
+  if (inotify_ < 0) {
+    throw std::system_error(errno, std::generic_category(), "inotify_init1");
+  }
+}
+
+Watcher::~Watcher() {
+  close(inotify_);
+}
+
+void Watcher::Watch(Program &program, std::vector<Stage> stages) {
+  auto entry = std::make_unique<Entry>(&program, std::move(stages));
+  for (const Stage &stage : entry->stages) {
+    for (std::string &file : library_.FilesOf(stage.name)) {
+      if (std::ranges::find(entry->files, file) == entry->files.end()) {
+        entry->files.push_back(std::move(file));
+      }
+    }
+  }
+  Index(*entry, entry->files);
+  entries_.push_back(std::move(entry));
+}
+
+void Watcher::Unwatch(const Program &program) {
+  const auto entry = std::ranges::find(entries_, &program, [](const auto &entry) { return entry->program; });
+  if (entry == entries_.end()) {
+    return;
+  }
+  Unindex(**entry, (*entry)->files);
+  entries_.erase(entry);
+}
+
+std::size_t Watcher::Poll() {
+  std::vector<std::string> changed;
+  alignas(inotify_event) char buffer[4096];
+  for (;;) {
+    const ssize_t size = read(inotify_, buffer, sizeof(buffer));
+    if (size <= 0) {
+      break;
+    }
+    for (ssize_t offset = 0; offset < size;) {
+      const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+      offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+      const auto directory = directories_.find(event->wd);
+      if (!event->len || directory == directories_.end()) {
+        continue;
+      }
+      std::string file = Normalize(std::filesystem::path(directory->second) / event->name);
+      if (dependents_.contains(file) && std::ranges::find(changed, file) == changed.end()) {
+        changed.push_back(std::move(file));
+      }
+    }
+  }
+
+  std::vector<Entry *> affected;
+  for (const std::string &file : changed) {
+    library_.Invalidate(file);
+    for (Entry *entry : dependents_.at(file)) {
+      if (std::ranges::find(affected, entry) == affected.end()) {
+        affected.push_back(entry);
+      }
+    }
+  }
+
+  std::size_t reloaded = 0;
+  for (Entry *entry : affected) {
+    reloaded += Rebuild(*entry);
+  }
+  return reloaded;
+}
+
+void Watcher::Index(Entry &entry, const std::vector<std::string> &files) {
+  for (const std::string &file : files) {
+    // The library hands out normalized names
+    const auto [dependents, inserted] = dependents_.try_emplace(file);
+    dependents->second.push_back(&entry);
+    if (!inserted) {
+      continue;
+    }
+
+    const std::string directory = Normalize(std::filesystem::path(file).parent_path());
+    if (const auto watch = watches_.find(directory); watch != watches_.end()) {
+      ++watch->second.files;
+      continue;
+    }
+    const int watch = inotify_add_watch(inotify_, (library_.root() / directory).c_str(), kEvents);
+    if (watch < 0) {
+      log_ << "Cannot watch " << (library_.root() / directory).string() << ": "
+        << std::generic_category().message(errno) << std::endl;
+      continue;
+    }
+    watches_[directory] = {watch, 1};
+    directories_[watch] = directory;
+  }
+}
+
+void Watcher::Unindex(const Entry &entry, const std::vector<std::string> &files) {
+  for (const std::string &file : files) {
+    const auto dependents = dependents_.find(file);
+    if (dependents == dependents_.end()) {
+      continue;
+    }
+    // One at a time, as Rebuild indexes the new files before unindexing the
+    // old ones
+    std::vector<Entry *> &entries = dependents->second;
+    if (const auto found = std::ranges::find(entries, &entry); found != entries.end()) {
+      entries.erase(found);
+    }
+    if (!entries.empty()) {
+      continue;
+    }
+    dependents_.erase(dependents);
+
+    const auto watch = watches_.find(Normalize(std::filesystem::path(file).parent_path()));
+    if (watch == watches_.end() || --watch->second.files) {
+      continue;
+    }
+    inotify_rm_watch(inotify_, watch->second.descriptor);
+    directories_.erase(watch->second.descriptor);
+    watches_.erase(watch);
+  }
+}
+
+bool Watcher::Rebuild(Entry &entry) {
+  try {
+    std::vector<Source> sources;
+    sources.reserve(entry.stages.size());
+    std::vector<std::string> files;
+    Program::Builder builder;
+    for (const Stage &stage : entry.stages) {
+      const std::vector<std::string_view> defines(stage.defines.begin(), stage.defines.end());
+      sources.push_back(library_.Load(stage.name, stage.type, defines));
+      builder.AttachSource(sources.back());
+      for (std::string &file : library_.FilesOf(stage.name)) {
+        if (std::ranges::find(files, file) == files.end()) {
+          files.push_back(std::move(file));
+        }
+      }
+    }
+    entry.program->Reload(builder.Link());
+
+    // An edit may have added or removed includes. The new files are indexed
+    // first, so directories still in use are not unwatched in between
+    Index(entry, files);
+    Unindex(entry, entry.files);
+    entry.files = std::move(files);
+    return true;
+  } catch (const ShaderException &error) {
+    log_ << "Keeping the previous version of";
+    for (const Stage &stage : entry.stages) {
+      log_ << ' ' << stage.name;
+    }
+    log_ << ": " << error.what() << std::endl;
+    return false;
+  }
+}
+}
@@ -0,0 +1,163 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/stream_buffer.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "embers/gl_state.h"
+
+namespace embers::gl {
+namespace {
+// Regions are mapped through a target nothing else depends on, so mapping
+// does not disturb the element array binding of the current vertex array
+constexpr GLenum kMapTarget = GL_COPY_WRITE_BUFFER;
+constexpr GLuint64 kWaitTimeout = 1'000'000'000;
+}
+
+StreamBuffer::StreamBuffer(const GLenum target, const GLsizeiptr size)
+  : target_(target)
+, buffer_(Buffer::Create())
+, size_(size) {
+  State::Current().BindBuffer(kMapTarget, buffer_.get());
+  glBufferData(kMapTarget, size_, nullptr, GL_STREAM_DRAW);
+}
+
+StreamBuffer::~StreamBuffer() {
+  if (mapped_) {
+    State::Current().BindBuffer(kMapTarget, buffer_.get());
+    glUnmapBuffer(kMapTarget);
+  }
+  for (const Frame &frame : frames_) {
+    glDeleteSync(frame.fence);
+  }
+}
+
+StreamBuffer::Region StreamBuffer::Map(const GLsizeiptr size, const GLsizeiptr alignment) {
+  if (mapped_) {
+    throw std::logic_error("StreamBuffer: a region is already mapped");
+  }
+  if (size <= 0 || size > size_) {
+    throw std::length_error("StreamBuffer: region does not fit in the buffer");
+  }
+  if (alignment <= 0 || (alignment & (alignment - 1)) != 0) {
+    throw std::invalid_argument("StreamBuffer: alignment must be a power of two");
+  }
+
+  const auto capacity = static_cast<std::size_t>(size_);
+  // The position in the buffer is aligned, not the offset counting wraps,
+  // unless the size happens to be a multiple of the alignment
+  const std::size_t position = head_ % capacity;
+  const std::size_t aligned = (position + alignment - 1) / alignment * alignment;
+  std::size_t start = head_ - position + aligned;
+  // Regions never straddle the end of the buffer
+  if (aligned + size > capacity) {
+    start = (head_ / capacity + 1) * capacity;
+    ++statistics_.wraps;
+  }
+  const std::size_t end = start + size;
+
+  // The region is reused from data at most one buffer size before it, which
+  // is in flight unless everything up to the head has been retired
+  const auto overlaps = [this, end, capacity] { return tail_ != head_ && end - tail_ > capacity; };
+  if (overlaps()) {
+    Retire(false);
+  }
+  if (overlaps()) {
+    const auto stall_start = std::chrono::steady_clock::now();
+    // The region overlaps this frame's own earlier regions; fence them too
+    if (frame_start_ != head_) {
+      EndFrame();
+    }
+    while (overlaps()) {
+      Retire(true);
+    }
+    ++statistics_.stalls;
+    statistics_.stall_time += std::chrono::steady_clock::now() - stall_start;
+  }
+
+  const auto offset = static_cast<GLintptr>(start % capacity);
+  State::Current().BindBuffer(kMapTarget, buffer_.get());
+  void *data = glMapBufferRange(
+    kMapTarget,
+    offset,
+    size,
+    GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT
+  );
+  if (!data) {
+    throw std::runtime_error("StreamBuffer: glMapBufferRange failed");
+  }
+  mapped_ = true;
+  head_ = end;
+  ++statistics_.allocations;
+  statistics_.bytes += size;
+  return {data, offset, size};
+}
+
+void StreamBuffer::Unmap() {
+  State::Current().BindBuffer(kMapTarget, buffer_.get());
+  mapped_ = false;
+  // The contents are lost if the driver had to give up the mapping
+  if (glUnmapBuffer(kMapTarget) == GL_FALSE) {
+    throw std::runtime_error("StreamBuffer: buffer contents were lost while mapped");
+  }
+}
+
+GLintptr StreamBuffer::Write(const void *data, const GLsizeiptr size, const GLsizeiptr alignment) {
+  const Region region = Map(size, alignment);
+  std::memcpy(region.data, data, size);
+  Unmap();
+  return region.offset;
+}
+
+void StreamBuffer::EndFrame() {
+  if (head_ != frame_start_) {
+    frames_.push_back({glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), head_});
+    frame_start_ = head_;
+  }
+  Retire(false);
+}
+
+void StreamBuffer::Retire(const bool block) {
+  while (!frames_.empty()) {
+    const Frame &frame = frames_.front();
+    GLenum status;
+    if (block) {
+      // Flushes, or a fence that was never submitted would never signal
+      while ((status = glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, kWaitTimeout)) == GL_TIMEOUT_EXPIRED) {}
+    } else {
+      status = glClientWaitSync(frame.fence, 0, 0);
+    }
+    if (status == GL_TIMEOUT_EXPIRED) {
+      return;
+    }
+    if (status == GL_WAIT_FAILED) {
+      throw std::runtime_error("StreamBuffer: glClientWaitSync failed");
+    }
+    tail_ = frame.end;
+    glDeleteSync(frame.fence);
+    frames_.pop_front();
+    if (block) {
+      return;
+    }
+  }
+}
+
+void StreamBuffer::Bind() const {
+  State::Current().BindBuffer(target_, buffer_.get());
+}
+
+void StreamBuffer::BindRange(const GLuint index, const GLintptr offset, const GLsizeiptr size) const {
+  State::Current().BindBufferRange(target_, index, buffer_.get(), offset, size);
+}
+
+void StreamBuffer::Report(std::ostream &output) const {
+  const std::chrono::duration<double, std::milli> stall_time = statistics_.stall_time;
+  output << "stream buffer: " << statistics_.allocations << " allocations, "
+    << statistics_.bytes << " bytes, "
+    << statistics_.wraps << " wraps, "
+    << statistics_.stalls << " stalls (" << stall_time.count() << " ms)" << std::endl;
+}
+}
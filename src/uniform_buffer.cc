@@ -0,0 +1,42 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/uniform_buffer.h"
+
+#include <cstring>
+
+#include "embers/gl_state.h"
+
+namespace embers::gl::detail {
+Buffer CreateUniformBuffer(const std::size_t size) {
+  Buffer buffer = Buffer::Create();
+  State::Current().BindBuffer(GL_UNIFORM_BUFFER, buffer.get());
+  glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_DYNAMIC_DRAW);
+  return buffer;
+}
+
+void UploadUniformBuffer(const GLuint buffer, const GLuint binding, const void *data, const std::size_t size) {
+  State &state = State::Current();
+  state.BindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(size), data);
+}
+
+void StreamUniformBuffer(
+  StreamBuffer &stream,
+  const GLuint binding,
+  const void *data,
+  const std::size_t size,
+  const std::size_t range
+) {
+  static const GLsizeiptr alignment = [] {
+    GLint value = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &value);
+    return value;
+  }();
+  const StreamBuffer::Region region = stream.Map(static_cast<GLsizeiptr>(range), alignment);
+  std::memcpy(region.data, data, size);
+  stream.Unmap();
+  stream.BindRange(binding, region.offset, region.size);
+}
+}
@@ -0,0 +1,66 @@
+//
+// Created by Naokitsu on 10/17/2026.
+//
+
+#include "embers/vertex.h"
+
+#include <bit>
+
+namespace embers::vertex {
+namespace {
+std::uint16_t FloatToHalf(const float value) {
+  const auto bits = std::bit_cast<std::uint32_t>(value);
+  const auto sign = static_cast<std::uint16_t>(bits >> 16 & 0x8000);
+  const std::uint32_t exponent = bits >> 23 & 0xFF;
+  std::uint32_t mantissa = bits & 0x7FFFFF;
+  if (exponent == 0xFF) {
+    // Infinity stays infinity, NaN stays a quiet NaN
+    return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+  }
+
+  const int half_exponent = static_cast<int>(exponent) - 127 + 15;
+  if (half_exponent >= 31) {
+    return sign | 0x7C00;
+  }
+  // Too small for a normal half, becomes a subnormal or zero
+  int shift = 13;
+  if (half_exponent <= 0) {
+    if (half_exponent < -10) {
+      return sign;
+    }
+    mantissa |= 0x800000;
+    shift = 14 - half_exponent;
+  }
+
+  std::uint32_t half = half_exponent > 0
+                         ? static_cast<std::uint32_t>(half_exponent) << 10 | mantissa >> shift
+                         : mantissa >> shift;
+  const std::uint32_t rest = mantissa & ((1u << shift) - 1);
+  const std::uint32_t halfway = 1u << (shift - 1);
+  // A carry out of the mantissa correctly bumps the exponent
+  if (rest > halfway || (rest == halfway && (half & 1))) {
+    ++half;
+  }
+  return static_cast<std::uint16_t>(sign | half);
+}
+}
+
+Half::Half(const float value) : bits(FloatToHalf(value)) {}
+
+void SetAttribute(
+  const GLuint location,
+  const Attribute &attribute,
+  const GLsizei stride,
+  const GLintptr offset,
+  const GLuint divisor
+) {
+  const auto *pointer = reinterpret_cast<const void *>(offset);
+  if (attribute.integer) {
+    glVertexAttribIPointer(location, attribute.size, attribute.type, stride, pointer);
+  } else {
+    glVertexAttribPointer(location, attribute.size, attribute.type, attribute.normalized, stride, pointer);
+  }
+  glEnableVertexAttribArray(location);
+  glVertexAttribDivisor(location, divisor);
+}
+}